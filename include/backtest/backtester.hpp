@@ -0,0 +1,284 @@
+#pragma once
+#include "backtest/sim_market.hpp"
+#include "core/orderbook.hpp"
+#include "core/types.hpp"
+#include "core/work_stealing_pool.hpp"
+#include "store/column_store.hpp"
+
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace poly {
+    // Cartesian product of named parameter values; combination i is decoded mixed-radix
+    struct ParamGrid {
+        std::vector<std::string> names;
+        std::vector<std::vector<double>> values;
+
+        void add(const std::string& name, std::vector<double> axis) {
+            names.push_back(name);
+            values.push_back(std::move(axis));
+        }
+
+        std::size_t size() const {
+            std::size_t n = values.empty() ? 0 : 1;
+            for (const auto& axis : values) n *= axis.size();
+            return n;
+        }
+
+        std::vector<double> at(std::size_t i) const {
+            std::vector<double> params(values.size());
+            for (std::size_t k = values.size(); k-- > 0;) {
+                params[k] = values[k][i % values[k].size()];
+                i /= values[k].size();
+            }
+            return params;
+        }
+    };
+
+    // What a strategy sees while a window is replayed
+    struct SimContext {
+        const std::string& asset;
+        Orderbook& book;
+        SimMarket& market;
+        uint64_t window_start;
+        uint64_t window_end;
+
+        uint64_t now() const { return market.now(); }
+
+        BookTop top() const {
+            BookTop t;
+            book.get_state(t.best_bid, t.best_ask, t.bid_depth, t.ask_depth);
+            t.timestamp_recv = market.now();
+            return t;
+        }
+    };
+
+    class IStrategy {
+    public:
+        virtual ~IStrategy() = default;
+
+        virtual void on_window_start(SimContext&) {}
+        virtual void on_book(SimContext& ctx) = 0;
+        virtual void on_trade(SimContext&, double /*price*/, double /*size*/, Side) {}
+        virtual void on_fill(SimContext&, const SimFill&) {}
+    };
+
+    using StrategyFactory = std::function<std::unique_ptr<IStrategy>(const std::vector<double>& params)>;
+
+    struct SweepResult {
+        std::vector<double> params;
+        double pnl = 0.0;
+        double worst_window = 0.0;
+        std::size_t windows = 0;
+        std::size_t fills = 0;
+        double volume = 0.0;
+    };
+
+    struct BacktestConfig {
+        uint64_t window_ms = 15 * 60 * 1000;
+        double taker_fee = 0.0;
+        std::size_t params_per_task = 32;
+        std::size_t threads = std::thread::hardware_concurrency();
+    };
+
+    // Replays *.book.pcol files through Orderbook + SimMarket. A file is one asset-day and
+    // its windows depend on each other through the book, so the unit of work is
+    // (file, chunk of parameter sets): the tape is decoded once per task and replayed for
+    // every parameter set of the chunk, and tasks are spread over a work-stealing pool.
+    class Backtester {
+        BacktestConfig cfg_;
+    public:
+        explicit Backtester(BacktestConfig cfg) : cfg_(cfg) {}
+
+        static std::vector<std::string> find_files(const std::string& root) {
+            std::vector<std::string> files;
+            std::error_code ec;
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(root, ec)) {
+                const std::string name = entry.path().filename().string();
+                if (entry.is_regular_file() && name.size() > 10 && name.ends_with(".book.pcol")) {
+                    files.push_back(entry.path().string());
+                }
+            }
+            if (ec) spdlog::error("Backtest: cannot scan {}: {}", root, ec.message());
+            std::sort(files.begin(), files.end());
+            return files;
+        }
+
+        std::vector<SweepResult> run(const std::vector<std::string>& files, const ParamGrid& grid,
+                                     const StrategyFactory& factory) const {
+            const std::size_t combos = grid.size();
+            std::vector<SweepResult> results(combos);
+            for (std::size_t i = 0; i < combos; ++i) {
+                results[i].params = grid.at(i);
+                results[i].worst_window = std::numeric_limits<double>::infinity();
+            }
+
+            std::mutex results_mtx;
+            const std::size_t chunk = std::max<std::size_t>(cfg_.params_per_task, 1);
+            {
+                WorkStealingPool pool(cfg_.threads);
+                for (const auto& file : files) {
+                    for (std::size_t first = 0; first < combos; first += chunk) {
+                        std::size_t last = std::min(combos, first + chunk);
+                        pool.submit([&, file, first, last] {
+                            Tape tape;
+                            if (!load(file, tape)) return;
+
+                            std::vector<SweepResult> local(last - first);
+                            for (std::size_t i = first; i < last; ++i) {
+                                try {
+                                    auto strategy = factory(results[i].params);
+                                    replay(tape, *strategy, local[i - first]);
+                                } catch (const std::exception& e) {
+                                    spdlog::error("Backtest: {} failed on {}: {}", tape.asset, i, e.what());
+                                }
+                            }
+
+                            std::lock_guard<std::mutex> lock(results_mtx);
+                            for (std::size_t i = first; i < last; ++i) merge(results[i], local[i - first]);
+                        });
+                    }
+                }
+                pool.wait();
+            }
+
+            for (auto& r : results) {
+                if (r.windows == 0) r.worst_window = 0.0;
+            }
+            return results;
+        }
+    private:
+        struct Tape {
+            std::string asset;
+            std::vector<int64_t> ts;
+            std::vector<int64_t> ts_exch;
+            std::vector<int64_t> kind;
+            std::vector<int64_t> side;
+            std::vector<double> price;
+            std::vector<double> size;
+        };
+
+        static bool load(const std::string& path, Tape& tape) {
+            ColumnReader reader;
+            if (!reader.open(path)) return false;
+
+            int ts = reader.column_index("timestamp_recv");
+            int ts_exch = reader.column_index("timestamp_exch");
+            int kind = reader.column_index("kind");
+            int side = reader.column_index("side");
+            int price = reader.column_index("price");
+            int size = reader.column_index("size");
+            if (ts < 0 || ts_exch < 0 || kind < 0 || side < 0 || price < 0 || size < 0) {
+                spdlog::error("Backtest: {} is not a book table", path);
+                return false;
+            }
+
+            RowRange all = reader.all();
+            tape.ts = reader.read_raw(ts, all);
+            tape.ts_exch = reader.read_raw(ts_exch, all);
+            tape.kind = reader.read_raw(kind, all);
+            tape.side = reader.read_raw(side, all);
+            tape.price = reader.read_values(price, all);
+            tape.size = reader.read_values(size, all);
+
+            // <VENUE>_<asset>.book.pcol
+            std::string name = std::filesystem::path(path).filename().string();
+            auto underscore = name.find('_');
+            tape.asset = name.substr(underscore + 1, name.size() - underscore - 1 - 10);
+            return true;
+        }
+
+        void replay(const Tape& tape, IStrategy& strategy, SweepResult& out) const {
+            Orderbook book;
+            SimMarket market(book, cfg_.taker_fee);
+            SimContext ctx{tape.asset, book, market, 0, 0};
+
+            const std::size_t rows = tape.ts.size();
+            uint64_t window = std::numeric_limits<uint64_t>::max();
+            double last_trade = 0.5;
+            bool snapshot = false;
+
+            auto close_window = [&] {
+                if (window == std::numeric_limits<uint64_t>::max()) return;
+                double pnl = market.equity(last_trade);
+                out.pnl += pnl;
+                out.worst_window = out.windows == 0 ? pnl : std::min(out.worst_window, pnl);
+                ++out.windows;
+                market.reset();
+            };
+
+            auto deliver_fills = [&] {
+                for (const auto& fill : market.drain_fills()) strategy.on_fill(ctx, fill);
+            };
+
+            for (std::size_t i = 0; i < rows; ++i) {
+                uint64_t ts = static_cast<uint64_t>(tape.ts[i]);
+                uint64_t w = ts / cfg_.window_ms;
+                if (w != window) {
+                    close_window();
+                    window = w;
+                    ctx.window_start = w * cfg_.window_ms;
+                    ctx.window_end = ctx.window_start + cfg_.window_ms;
+                    market.set_time(ts);
+                    strategy.on_window_start(ctx);
+                }
+                market.set_time(ts);
+                market.set_exchange_time(static_cast<uint64_t>(tape.ts_exch[i]));
+
+                auto kind = static_cast<BookRowKind>(tape.kind[i]);
+                if (kind == BookRowKind::TRADE) {
+                    Side aggressor = tape.side[i] > 0 ? Side::BUY : Side::SELL;
+                    last_trade = tape.price[i];
+                    market.on_trade(tape.price[i], tape.size[i], aggressor);
+                    deliver_fills();
+                    strategy.on_trade(ctx, tape.price[i], tape.size[i], aggressor);
+                    continue;
+                }
+
+                if (kind == BookRowKind::SNAPSHOT) {
+                    book.clear();
+                    snapshot = true;
+                } else {
+                    bool is_bid = tape.side[i] > 0;
+                    double old_size = book.size_at(is_bid, tape.price[i]);
+                    book.update(is_bid, tape.price[i], tape.size[i]);
+                    market.on_level(is_bid, tape.price[i], old_size, tape.size[i]);
+                }
+
+                // Rows of one frame share a receive time; the strategy sees the book once per frame
+                bool frame_done = i + 1 == rows || tape.ts[i + 1] != tape.ts[i]
+                    || static_cast<BookRowKind>(tape.kind[i + 1]) != BookRowKind::LEVEL;
+                if (!frame_done) continue;
+
+                if (snapshot) market.on_snapshot();
+                snapshot = false;
+                market.on_book_change();
+                deliver_fills();
+                strategy.on_book(ctx);
+                deliver_fills();
+            }
+            close_window();
+
+            out.fills += market.fill_count();
+            out.volume += market.volume();
+        }
+
+        static void merge(SweepResult& into, const SweepResult& from) {
+            if (from.windows == 0) return;
+            into.pnl += from.pnl;
+            into.worst_window = std::min(into.worst_window, from.worst_window);
+            into.windows += from.windows;
+            into.fills += from.fills;
+            into.volume += from.volume;
+        }
+    };
+}
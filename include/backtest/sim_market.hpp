@@ -0,0 +1,253 @@
+#pragma once
+#include "core/orderbook.hpp"
+#include "core/types.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace poly {
+    struct SimOrder {
+        uint64_t id;
+        Side side;
+        double price;
+        double remaining;
+        double queue_ahead;  // resting size estimated to be in front of us at our price
+    };
+
+    struct SimFill {
+        uint64_t order_id;  // 0 for market orders
+        Side side;
+        double price;
+        double size;
+        bool passive;
+        uint64_t timestamp;
+    };
+
+    // Simulated exchange for one asset on top of a replayed Orderbook. Our orders never
+    // change the replayed book; passive fills are estimated from queue position and the
+    // trade tape, aggressive fills walk the levels that were resting at the time.
+    class SimMarket {
+        Orderbook& book_;
+        double taker_fee_;
+
+        // Prints and level decreases at one (is_bid, price) within the current match group.
+        // A print and the decrease it causes can arrive in either order, so the decrease is
+        // only treated as cancels once the group is over and no print has explained it.
+        struct Pending {
+            double traded = 0.0;    // printed volume no decrease has shown yet
+            double decrease = 0.0;  // decrease no print has explained yet
+            double old_size = 0.0;  // level size before that decrease
+        };
+
+        std::vector<SimOrder> orders_;
+        std::vector<SimFill> fills_;
+        std::map<std::pair<bool, double>, Pending> pending_;
+        uint64_t group_ = 0;
+        uint64_t next_id_ = 1;
+        uint64_t now_ = 0;
+
+        double position_ = 0.0;
+        double cash_ = 0.0;
+        double volume_ = 0.0;
+        std::size_t fill_count_ = 0;
+    public:
+        static constexpr double kEps = 1e-9;
+
+        explicit SimMarket(Orderbook& book, double taker_fee = 0.0) : book_(book), taker_fee_(taker_fee) {}
+
+        void set_time(uint64_t ts) { now_ = ts; }
+
+        // Rows with the same exchange timestamp form one match group; a print and a level
+        // decrease are paired only inside a group. Call set_time() first, rows without an
+        // exchange timestamp are grouped by receive time.
+        void set_exchange_time(uint64_t ts) {
+            uint64_t group = ts != 0 ? ts : now_;
+            if (group == group_) return;
+            settle();
+            group_ = group;
+        }
+        uint64_t now() const { return now_; }
+
+        double position() const { return position_; }
+        double cash() const { return cash_; }
+        double volume() const { return volume_; }
+        std::size_t fill_count() const { return fill_count_; }
+        const std::vector<SimOrder>& orders() const { return orders_; }
+
+        // Marketable part trades immediately up to the limit; the rest rests behind the
+        // size already displayed at that price
+        uint64_t place_limit(Side side, double price, double size) {
+            if (size <= kEps || side == Side::UNKNOWN) return 0;
+            uint64_t id = next_id_++;
+            double left = size - take_liquidity(side, size, price, id);
+            if (left > kEps) {
+                orders_.push_back({id, side, price, left, book_.size_at(side == Side::BUY, price)});
+            }
+            return id;
+        }
+
+        // Walks the opposite side without a price limit; returns the filled size
+        double market(Side side, double size) {
+            if (side == Side::UNKNOWN) return 0.0;
+            return take_liquidity(side, size, side == Side::BUY ? 1e300 : -1e300, 0);
+        }
+
+        bool cancel(uint64_t id) {
+            auto it = std::find_if(orders_.begin(), orders_.end(), [id](const SimOrder& o) { return o.id == id; });
+            if (it == orders_.end()) return false;
+            orders_.erase(it);
+            return true;
+        }
+
+        void cancel_all() { orders_.clear(); }
+
+        // Replay hooks, called by the backtester for every book row
+
+        void on_level(bool is_bid, double price, double old_size, double new_size) {
+            if (new_size >= old_size) return;
+
+            auto& p = pending_[{is_bid, price}];
+            if (p.decrease <= kEps) p.old_size = old_size;
+            p.decrease += old_size - new_size;
+            match(p);
+        }
+
+        void on_snapshot() {
+            pending_.clear();
+            for (auto& o : orders_) {
+                o.queue_ahead = std::min(o.queue_ahead, book_.size_at(o.side == Side::BUY, o.price));
+            }
+        }
+
+        // A print at our price eats the queue in front of us first; a print through our price
+        // means everything at our price traded. aggressor is the taker's side, so a BUY only
+        // reaches resting asks; UNKNOWN reaches both sides.
+        void on_trade(double price, double size, Side aggressor = Side::UNKNOWN) {
+            if (aggressor != Side::UNKNOWN) {
+                auto& p = pending_[{aggressor == Side::SELL, price}];
+                p.traded += size;
+                match(p);
+            }
+            for (auto& o : orders_) {
+                if (aggressor != Side::UNKNOWN && o.side == aggressor) continue;
+                bool through = o.side == Side::BUY ? price < o.price : price > o.price;
+                if (through) {
+                    fill_passive(o, o.remaining);
+                } else if (price == o.price) {
+                    double ahead = o.queue_ahead;
+                    o.queue_ahead = std::max(0.0, ahead - size);
+                    if (size > ahead) fill_passive(o, std::min(o.remaining, size - ahead));
+                }
+            }
+            erase_done();
+        }
+
+        // Ends the current match group: decreases no print explained are cancels, spread
+        // evenly over the queue; prints no decrease showed are dropped
+        void settle() {
+            for (const auto& [key, p] : pending_) {
+                if (p.decrease <= kEps || p.old_size <= kEps) continue;
+                const auto& [is_bid, price] = key;
+                Side side = is_bid ? Side::BUY : Side::SELL;
+                for (auto& o : orders_) {
+                    if (o.side != side || o.price != price) continue;
+                    o.queue_ahead -= p.decrease * o.queue_ahead / p.old_size;
+                    o.queue_ahead = std::clamp(o.queue_ahead, 0.0, book_.size_at(is_bid, price));
+                }
+            }
+            pending_.clear();
+        }
+
+        // Resting orders the book has moved through would have been hit
+        void on_book_change() {
+            double best_bid, best_ask, bid_depth, ask_depth;
+            size_t bids, asks;
+            book_.get_state(best_bid, best_ask, bid_depth, ask_depth);
+            book_.get_levels(bids, asks);
+            for (auto& o : orders_) {
+                bool crossed = o.side == Side::BUY
+                    ? (asks > 0 && (o.price > best_ask || (o.price == best_ask && o.queue_ahead <= kEps)))
+                    : (bids > 0 && (o.price < best_bid || (o.price == best_bid && o.queue_ahead <= kEps)));
+                if (crossed) fill_passive(o, o.remaining);
+            }
+            erase_done();
+        }
+
+        std::vector<SimFill> drain_fills() {
+            std::vector<SimFill> out;
+            out.swap(fills_);
+            return out;
+        }
+
+        // Value of cash plus position at the mid, or at fallback when one side is empty
+        double equity(double fallback) {
+            double best_bid, best_ask, bid_depth, ask_depth;
+            size_t bids, asks;
+            book_.get_state(best_bid, best_ask, bid_depth, ask_depth);
+            book_.get_levels(bids, asks);
+            double mark = (bids > 0 && asks > 0) ? (best_bid + best_ask) / 2.0 : fallback;
+            return cash_ + position_ * mark;
+        }
+
+        // Flattens the account between independent windows
+        void reset() {
+            orders_.clear();
+            pending_.clear();
+            fills_.clear();
+            position_ = 0.0;
+            cash_ = 0.0;
+        }
+    private:
+        // The printed part of a decrease already moved the queue in on_trade(), so it is
+        // neither a cancel nor part of the queue the remaining cancels are spread over
+        static void match(Pending& p) {
+            double explained = std::min(p.traded, p.decrease);
+            p.traded -= explained;
+            p.decrease -= explained;
+            p.old_size -= explained;
+        }
+
+        double take_liquidity(Side side, double size, double limit, uint64_t id) {
+            double filled = 0.0;
+            bool buy = side == Side::BUY;
+            book_.for_each_level(!buy, [&](double price, double level_size) {
+                if (filled >= size - kEps) return false;
+                if (buy ? price > limit : price < limit) return false;
+                double qty = std::min(level_size, size - filled);
+                book_fill(side, price, qty, false, id);
+                filled += qty;
+                return true;
+            });
+            return filled;
+        }
+
+        void fill_passive(SimOrder& o, double qty) {
+            if (qty <= kEps) return;
+            book_fill(o.side, o.price, qty, true, o.id);
+            o.remaining -= qty;
+        }
+
+        void book_fill(Side side, double price, double qty, bool passive, uint64_t id) {
+            double notional = price * qty;
+            if (side == Side::BUY) {
+                position_ += qty;
+                cash_ -= notional;
+            } else {
+                position_ -= qty;
+                cash_ += notional;
+            }
+            if (!passive) cash_ -= notional * taker_fee_;
+            volume_ += qty;
+            ++fill_count_;
+            fills_.push_back({id, side, price, qty, passive, now_});
+        }
+
+        void erase_done() {
+            orders_.erase(std::remove_if(orders_.begin(), orders_.end(),
+                [](const SimOrder& o) { return o.remaining <= kEps; }), orders_.end());
+        }
+    };
+}
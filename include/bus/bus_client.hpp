@@ -0,0 +1,228 @@
+#pragma once
+#include "bus/market_bus.hpp"
+
+#include <spdlog/spdlog.h>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace poly {
+    // Read side of the market-data bus. Any number of processes can attach; nothing is
+    // ever written to the region, so a slow or crashed reader cannot affect the feed.
+    //
+    // Reads are not zero-copy: next() and book() copy the slot into the caller's BusEvent /
+    // BookTop. A seqlock reader may only trust what it read after checking the sequence
+    // again, and the writer can reuse the slot as soon as that check is done, so a
+    // reference into the ring would not stay valid. The copy is small (168 bytes per
+    // event, 40 per book) next to the cache misses it takes to read the slot at all.
+    class MarketBusReader {
+        std::string name_;
+        std::size_t size_ = 0;
+        void* base_ = nullptr;
+
+        const bus::Header* header_ = nullptr;
+        const bus::EventSlot* ring_ = nullptr;
+        const bus::BookSlot* books_ = nullptr;
+        uint64_t mask_ = 0;
+
+        uint64_t cursor_ = 0;
+        uint64_t lost_ = 0;
+        mutable std::unordered_map<std::string, uint32_t> book_index_;
+
+        // Identity of the region we mapped, to spot a writer that replaced it
+        dev_t dev_ = 0;
+        ino_t ino_ = 0;
+        mutable std::chrono::steady_clock::time_point next_check_{};
+
+        static constexpr std::chrono::milliseconds kLivenessCheck{500};
+    public:
+        enum class ReadStatus {
+            OK,
+            EMPTY,
+            OVERRUN  // the writer lapped us; cursor moved forward, see lost()
+        };
+
+        explicit MarketBusReader(std::string name) : name_(std::move(name)) {}
+
+        MarketBusReader(const MarketBusReader&) = delete;
+        MarketBusReader& operator=(const MarketBusReader&) = delete;
+
+        ~MarketBusReader() { detach(); }
+
+        // Maps the region and positions the cursor at the live head. Call snapshot()
+        // afterwards to get the books as of attach time.
+        bool attach() {
+            detach();
+
+            int fd = ::shm_open(name_.c_str(), O_RDONLY, 0);
+            if (fd < 0) {
+                spdlog::error("Bus {}: shm_open failed: {}", name_, std::strerror(errno));
+                return false;
+            }
+
+            struct stat st{};
+            if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(bus::Header)) {
+                spdlog::error("Bus {}: region missing or truncated", name_);
+                ::close(fd);
+                return false;
+            }
+
+            size_ = static_cast<std::size_t>(st.st_size);
+            void* base = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+            ::close(fd);
+            if (base == MAP_FAILED) {
+                spdlog::error("Bus {}: mmap failed: {}", name_, std::strerror(errno));
+                return false;
+            }
+            base_ = base;
+            header_ = static_cast<const bus::Header*>(base_);
+            dev_ = st.st_dev;
+            ino_ = st.st_ino;
+            next_check_ = std::chrono::steady_clock::now() + kLivenessCheck;
+
+            if (header_->magic.load(std::memory_order_acquire) != bus::kMagic
+                || header_->version != bus::kVersion
+                || size_ < bus::region_size(header_->ring_capacity, header_->book_capacity)) {
+                spdlog::error("Bus {}: not initialised or incompatible layout", name_);
+                detach();
+                return false;
+            }
+
+            ring_ = bus::event_slots(base_);
+            books_ = bus::book_slots(base_, header_->ring_capacity);
+            mask_ = header_->ring_capacity - 1;
+            cursor_ = header_->head.load(std::memory_order_acquire);
+            lost_ = 0;
+            book_index_.clear();
+            return true;
+        }
+
+        void detach() {
+            if (base_) ::munmap(base_, size_);
+            base_ = nullptr;
+            header_ = nullptr;
+        }
+
+        bool attached() const { return base_ != nullptr; }
+
+        // False once the feed process has shut down or restarted; re-attach to follow the new one.
+        // A clean shutdown shows up at once, a restart that skipped the writer's destructor
+        // (crash, kill -9) within kLivenessCheck.
+        bool writer_alive() const {
+            if (!base_ || header_->writer_closed.load(std::memory_order_acquire) != 0) return false;
+
+            auto now = std::chrono::steady_clock::now();
+            if (now < next_check_) return true;
+            next_check_ = now + kLivenessCheck;
+            return same_region();
+        }
+
+        uint64_t lost() const { return lost_; }
+
+        uint64_t lag() const {
+            return base_ ? header_->head.load(std::memory_order_acquire) - cursor_ : 0;
+        }
+
+        ReadStatus next(BusEvent& out) {
+            if (!base_) return ReadStatus::EMPTY;
+
+            uint64_t head = header_->head.load(std::memory_order_acquire);
+            if (cursor_ == head) return ReadStatus::EMPTY;
+
+            uint64_t capacity = mask_ + 1;
+            if (head - cursor_ > capacity) {
+                skip_to(head - capacity);
+                return ReadStatus::OVERRUN;
+            }
+
+            const bus::EventSlot& slot = ring_[cursor_ & mask_];
+            uint64_t expected = 2 * cursor_ + 2;
+            uint64_t s1 = slot.seq.load(std::memory_order_acquire);
+            if (s1 == expected) {
+                std::memcpy(&out, &slot.evt, sizeof(BusEvent));
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.seq.load(std::memory_order_relaxed) == expected) {
+                    ++cursor_;
+                    return ReadStatus::OK;
+                }
+            }
+
+            // The slot was recycled while we looked at it: the writer is a full ring ahead
+            head = header_->head.load(std::memory_order_acquire);
+            skip_to(head > capacity ? head - capacity + 1 : cursor_ + 1);
+            return ReadStatus::OVERRUN;
+        }
+
+        bool book(const std::string& asset, BookTop& out) const {
+            if (!base_) return false;
+
+            auto it = book_index_.find(asset);
+            if (it == book_index_.end()) {
+                refresh_index();
+                it = book_index_.find(asset);
+                if (it == book_index_.end()) return false;
+            }
+            read_book(books_[it->second], out);
+            return true;
+        }
+
+        // Consistent copy of every published top of book, for late joiners
+        std::vector<std::pair<std::string, BookTop>> snapshot() const {
+            std::vector<std::pair<std::string, BookTop>> result;
+            if (!base_) return result;
+
+            refresh_index();
+            result.reserve(book_index_.size());
+            for (const auto& [asset, idx] : book_index_) {
+                BookTop top;
+                read_book(books_[idx], top);
+                result.emplace_back(asset, top);
+            }
+            return result;
+        }
+    private:
+        // The name still refers to the region we mapped (a restarted writer unlinks and recreates it)
+        bool same_region() const {
+            int fd = ::shm_open(name_.c_str(), O_RDONLY, 0);
+            if (fd < 0) return false;
+            struct stat st{};
+            bool same = ::fstat(fd, &st) == 0 && st.st_dev == dev_ && st.st_ino == ino_;
+            ::close(fd);
+            return same;
+        }
+
+        void skip_to(uint64_t target) {
+            if (target <= cursor_) return;
+            lost_ += target - cursor_;
+            cursor_ = target;
+        }
+
+        void refresh_index() const {
+            uint32_t count = std::min(header_->book_count.load(std::memory_order_acquire),
+                                      header_->book_capacity);
+            for (uint32_t i = static_cast<uint32_t>(book_index_.size()); i < count; ++i) {
+                book_index_.emplace(std::string(books_[i].symbol), i);
+            }
+        }
+
+        static void read_book(const bus::BookSlot& slot, BookTop& out) {
+            for (;;) {
+                uint64_t s1 = slot.seq.load(std::memory_order_acquire);
+                if (s1 & 1) continue;
+                std::memcpy(&out, &slot.book, sizeof(BookTop));
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.seq.load(std::memory_order_relaxed) == s1) return;
+            }
+        }
+    };
+}
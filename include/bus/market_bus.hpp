@@ -0,0 +1,236 @@
+#pragma once
+#include "core/types.hpp"
+
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace poly {
+    // Polymarket token ids are 77 decimal digits
+    constexpr std::size_t kBusSymbolLen = 80;
+
+    // Fixed-size image of a MarketEvent as it sits in shared memory (no payload)
+    struct BusEvent {
+        uint64_t timestamp_exch;
+        uint64_t timestamp_recv;
+        uint64_t timestamp_recv_ns;    // frame handed to the feed, system clock
+        uint64_t timestamp_kernel_ns;  // kernel receive time of that frame, 0 without SO_TIMESTAMPING
+        double price;
+        double size;
+        double best_bid;
+        double best_ask;
+        double bid_depth;
+        double ask_depth;
+        Venue venue;
+        Side side;
+        char symbol[kBusSymbolLen];
+    };
+
+    static_assert(std::is_trivially_copyable_v<BusEvent>);
+    static_assert(std::is_trivially_copyable_v<BookTop>);
+
+    namespace bus {
+        constexpr uint64_t kMagic = 0x31535542594c4f50ULL; // "POLYBUS1"
+        constexpr uint32_t kVersion = 2;
+
+        // Layout of the /dev/shm region: Header | EventSlot[ring_capacity] | BookSlot[book_capacity].
+        // Every slot is a seqlock: odd sequence while the writer is inside it, even once published.
+        struct alignas(64) Header {
+            std::atomic<uint64_t> magic;
+            uint32_t version;
+            uint32_t ring_capacity;
+            uint32_t book_capacity;
+            std::atomic<uint32_t> writer_closed;
+
+            alignas(64) std::atomic<uint64_t> head;        // events published so far
+            alignas(64) std::atomic<uint32_t> book_count;  // book slots claimed so far
+        };
+
+        struct alignas(64) EventSlot {
+            std::atomic<uint64_t> seq;  // 2n+1 while writing event n, 2n+2 once it is readable
+            BusEvent evt;
+        };
+
+        struct alignas(64) BookSlot {
+            std::atomic<uint64_t> seq;
+            char symbol[kBusSymbolLen];
+            BookTop book;
+        };
+
+        static_assert(std::atomic<uint64_t>::is_always_lock_free);
+        static_assert(std::atomic<uint32_t>::is_always_lock_free);
+
+        inline std::size_t region_size(uint32_t ring_capacity, uint32_t book_capacity) {
+            return sizeof(Header) + sizeof(EventSlot) * ring_capacity + sizeof(BookSlot) * book_capacity;
+        }
+
+        inline EventSlot* event_slots(void* base) {
+            return reinterpret_cast<EventSlot*>(static_cast<char*>(base) + sizeof(Header));
+        }
+
+        inline BookSlot* book_slots(void* base, uint32_t ring_capacity) {
+            return reinterpret_cast<BookSlot*>(static_cast<char*>(base) + sizeof(Header)
+                + sizeof(EventSlot) * ring_capacity);
+        }
+
+        inline void copy_symbol(char (&dst)[kBusSymbolLen], const std::string& src) {
+            std::size_t n = std::min(src.size(), kBusSymbolLen - 1);
+            std::memcpy(dst, src.data(), n);
+            std::memset(dst + n, 0, kBusSymbolLen - n);
+        }
+    }
+
+    // Single producer side of the market-data bus. Lives in the feed process and is fed
+    // from the feed callbacks, which all run on the io_context thread.
+    class MarketBusWriter {
+        std::string name_;
+        uint32_t ring_capacity_;
+        uint32_t book_capacity_;
+        std::size_t size_ = 0;
+        void* base_ = nullptr;
+
+        bus::Header* header_ = nullptr;
+        bus::EventSlot* ring_ = nullptr;
+        bus::BookSlot* books_ = nullptr;
+        std::unordered_map<std::string, uint32_t> book_index_;
+    public:
+        // ring_capacity must be a power of two
+        explicit MarketBusWriter(std::string name, uint32_t ring_capacity = 1u << 16,
+                                 uint32_t book_capacity = 1024)
+            : name_(std::move(name)), ring_capacity_(ring_capacity), book_capacity_(book_capacity) {}
+
+        MarketBusWriter(const MarketBusWriter&) = delete;
+        MarketBusWriter& operator=(const MarketBusWriter&) = delete;
+
+        ~MarketBusWriter() {
+            if (!base_) return;
+            header_->writer_closed.store(1, std::memory_order_release);
+            ::munmap(base_, size_);
+            ::shm_unlink(name_.c_str());
+        }
+
+        bool open() {
+            if (ring_capacity_ == 0 || (ring_capacity_ & (ring_capacity_ - 1)) != 0) {
+                spdlog::error("Bus {}: ring capacity {} is not a power of two", name_, ring_capacity_);
+                return false;
+            }
+
+            // Start from a fresh region; readers of a previous run notice that the name now
+            // refers to another region (MarketBusReader::writer_alive) and re-attach
+            ::shm_unlink(name_.c_str());
+            int fd = ::shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+            if (fd < 0) {
+                spdlog::error("Bus {}: shm_open failed: {}", name_, std::strerror(errno));
+                return false;
+            }
+
+            size_ = bus::region_size(ring_capacity_, book_capacity_);
+            if (::ftruncate(fd, static_cast<off_t>(size_)) != 0) {
+                spdlog::error("Bus {}: ftruncate failed: {}", name_, std::strerror(errno));
+                ::close(fd);
+                ::shm_unlink(name_.c_str());
+                return false;
+            }
+
+            void* base = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            ::close(fd);
+            if (base == MAP_FAILED) {
+                spdlog::error("Bus {}: mmap failed: {}", name_, std::strerror(errno));
+                ::shm_unlink(name_.c_str());
+                return false;
+            }
+
+            base_ = base;
+            header_ = static_cast<bus::Header*>(base_);
+            ring_ = bus::event_slots(base_);
+            books_ = bus::book_slots(base_, ring_capacity_);
+
+            // ftruncate zero-fills, so every slot already has seq 0 and head is 0
+            header_->version = bus::kVersion;
+            header_->ring_capacity = ring_capacity_;
+            header_->book_capacity = book_capacity_;
+            header_->magic.store(bus::kMagic, std::memory_order_release);
+
+            spdlog::info("Bus {} ready ({} event slots, {} book slots, {} KiB)",
+                name_, ring_capacity_, book_capacity_, size_ / 1024);
+            return true;
+        }
+
+        bool is_open() const { return base_ != nullptr; }
+
+        void publish(const MarketEvent& evt) {
+            if (!base_) return;
+
+            uint64_t n = header_->head.load(std::memory_order_relaxed);
+            bus::EventSlot& slot = ring_[n & (ring_capacity_ - 1)];
+
+            slot.seq.store(2 * n + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            BusEvent& out = slot.evt;
+            out.timestamp_exch = evt.timestamp_exch;
+            out.timestamp_recv = evt.timestamp_recv;
+            out.timestamp_recv_ns = evt.timestamp_recv_ns;
+            out.timestamp_kernel_ns = evt.timestamp_kernel_ns;
+            out.price = evt.price;
+            out.size = evt.size;
+            out.best_bid = evt.best_bid;
+            out.best_ask = evt.best_ask;
+            out.bid_depth = evt.bid_depth;
+            out.ask_depth = evt.ask_depth;
+            out.venue = evt.venue;
+            out.side = evt.side;
+            bus::copy_symbol(out.symbol, evt.symbol);
+
+            slot.seq.store(2 * n + 2, std::memory_order_release);
+            header_->head.store(n + 1, std::memory_order_release);
+        }
+
+        void publish_book(const std::string& asset, const BookTop& top) {
+            if (!base_) return;
+
+            auto it = book_index_.find(asset);
+            if (it == book_index_.end()) {
+                claim_book_slot(asset, top);
+                return;
+            }
+            if (it->second >= book_capacity_) return;
+
+            bus::BookSlot& slot = books_[it->second];
+            uint64_t s = slot.seq.load(std::memory_order_relaxed);
+            slot.seq.store(s + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            slot.book = top;
+            slot.seq.store(s + 2, std::memory_order_release);
+        }
+    private:
+        void claim_book_slot(const std::string& asset, const BookTop& top) {
+            uint32_t idx = header_->book_count.load(std::memory_order_relaxed);
+            if (idx >= book_capacity_) {
+                spdlog::warn("Bus {}: book table full, dropping top of book for {}", name_, asset);
+                book_index_.emplace(asset, book_capacity_);
+                return;
+            }
+
+            // Symbol and first book are in place before the slot becomes visible through book_count
+            bus::BookSlot& slot = books_[idx];
+            bus::copy_symbol(slot.symbol, asset);
+            slot.book = top;
+            slot.seq.store(2, std::memory_order_relaxed);
+            header_->book_count.store(idx + 1, std::memory_order_release);
+            book_index_.emplace(asset, idx);
+        }
+    };
+}
@@ -3,7 +3,6 @@
 #include <map>
 #include <vector>
 #include <string>
-#include <mutex>
 #include <algorithm>
 
 namespace poly {
@@ -12,14 +11,12 @@ namespace poly {
         double size;
     };
 
+    // Not synchronized: a book belongs to one thread (a PolyFeed book worker, a backtest task)
     class Orderbook {
         std::map<double, double, std::greater<double>> bids_;
         std::map<double, double, std::less<double>> asks_;
-
-        mutable std::mutex mtx_;
     public:
         void update(bool is_bid, double price, double size) {
-            std::lock_guard<std::mutex> lock(mtx_);
             if (is_bid) {
                 if (size <= 1e-9) bids_.erase(price);
                 else bids_[price] = size;
@@ -30,14 +27,12 @@ namespace poly {
         }
 
         void get_state(double& best_bid, double& best_ask, double& bid_depth, double& ask_depth) {
-            std::lock_guard<std::mutex> lock(mtx_);
-
             if (bids_.empty()) {best_bid = 0; bid_depth = 0;}
             else {
                 best_bid = bids_.begin()->first;
                 bid_depth = bids_.begin()->second;
             }
-            if (asks_.empty()) {best_ask = 1; bid_depth = 0;}
+            if (asks_.empty()) {best_ask = 1; ask_depth = 0;}
             else {
                 best_ask = asks_.begin()->first;
                 ask_depth = asks_.begin()->second;
@@ -45,8 +40,31 @@ namespace poly {
 
         }
 
+        double size_at(bool is_bid, double price) {
+            if (is_bid) {
+                auto it = bids_.find(price);
+                return it == bids_.end() ? 0.0 : it->second;
+            }
+            auto it = asks_.find(price);
+            return it == asks_.end() ? 0.0 : it->second;
+        }
+
+        // Visits levels best first until fn(price, size) returns false
+        template <class F>
+        void for_each_level(bool is_bid, F&& fn) {
+            if (is_bid) {
+                for (const auto& [price, size] : bids_) if (!fn(price, size)) return;
+            } else {
+                for (const auto& [price, size] : asks_) if (!fn(price, size)) return;
+            }
+        }
+
+        void get_levels(size_t& bid_levels, size_t& ask_levels) {
+            bid_levels = bids_.size();
+            ask_levels = asks_.size();
+        }
+
         void clear() {
-            std::lock_guard<std::mutex> lock(mtx_);
             bids_.clear();
             asks_.clear();
         }
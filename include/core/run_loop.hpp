@@ -0,0 +1,38 @@
+#pragma once
+#include <boost/asio/io_context.hpp>
+#include <spdlog/spdlog.h>
+#include <cstring>
+
+#include <pthread.h>
+#include <sched.h>
+
+namespace poly {
+    struct RunLoopConfig {
+        bool busy_poll = false;  // spin on poll() instead of sleeping in epoll_wait
+        int cpu = -1;            // core to pin the I/O thread to, -1 leaves it unpinned
+    };
+
+    inline bool pin_current_thread(int cpu) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if (rc != 0) {
+            spdlog::warn("Cannot pin thread to cpu {}: {}", cpu, std::strerror(rc));
+            return false;
+        }
+        return true;
+    }
+
+    // Drives the io_context on the calling thread until it runs out of work or is stopped.
+    // Busy polling trades a full core for skipping the epoll sleep/wake-up on every
+    // message; it only makes sense together with pinning to an isolated core.
+    inline void run_io(boost::asio::io_context& ioc, const RunLoopConfig& cfg) {
+        if (cfg.cpu >= 0) pin_current_thread(cfg.cpu);
+        if (!cfg.busy_poll) {
+            ioc.run();
+            return;
+        }
+        while (!ioc.stopped()) ioc.poll();
+    }
+}
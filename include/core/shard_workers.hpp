@@ -0,0 +1,140 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace poly {
+    // N worker threads, each fed by its own bounded single-producer ring. Items pushed to a
+    // shard are handled by that shard's thread in push order, so state keyed by shard_of()
+    // can be owned by one worker and touched without locks. Only one thread (or strand)
+    // may push. Idle workers spin briefly, then sleep until the producer wakes them.
+    template <class Item>
+    class ShardWorkers {
+    public:
+        using Handler = std::function<void(std::size_t shard, Item& item)>;
+        // Called by a worker each time it has handled everything it found queued
+        using DrainedHandler = std::function<void(std::size_t shard)>;
+    private:
+        struct alignas(64) Shard {
+            std::unique_ptr<Item[]> slots;
+            alignas(64) std::atomic<uint64_t> head{0};  // next slot to handle, written by the worker
+            alignas(64) std::atomic<uint64_t> tail{0};  // next slot to fill, written by the producer
+            std::atomic<bool> sleeping{false};
+            std::mutex mtx;
+            std::condition_variable cv;
+            std::thread thread;
+        };
+
+        static constexpr int kSpins = 256;
+
+        Handler handler_;
+        DrainedHandler drained_;
+        std::size_t capacity_;
+        std::vector<std::unique_ptr<Shard>> shards_;
+        std::atomic<bool> stop_{false};
+    public:
+        // capacity is rounded up to a power of two
+        ShardWorkers(std::size_t shards, Handler handler, std::size_t capacity = 4096,
+                     DrainedHandler drained = {})
+            : handler_(std::move(handler)), drained_(std::move(drained)), capacity_(1) {
+            while (capacity_ < capacity) capacity_ <<= 1;
+            shards = std::max<std::size_t>(shards, 1);
+            for (std::size_t i = 0; i < shards; ++i) {
+                auto s = std::make_unique<Shard>();
+                s->slots = std::make_unique<Item[]>(capacity_);
+                shards_.push_back(std::move(s));
+            }
+            for (std::size_t i = 0; i < shards; ++i) {
+                shards_[i]->thread = std::thread([this, i] { work(i); });
+            }
+        }
+
+        ShardWorkers(const ShardWorkers&) = delete;
+        ShardWorkers& operator=(const ShardWorkers&) = delete;
+
+        // Workers finish what is already queued before they exit
+        ~ShardWorkers() {
+            stop_.store(true);
+            for (auto& s : shards_) {
+                {
+                    std::lock_guard<std::mutex> lock(s->mtx);
+                }
+                s->cv.notify_one();
+            }
+            for (auto& s : shards_) s->thread.join();
+        }
+
+        std::size_t size() const { return shards_.size(); }
+
+        std::size_t shard_of(std::string_view key) const {
+            return std::hash<std::string_view>{}(key) % shards_.size();
+        }
+
+        // Items queued but not yet handled
+        std::size_t depth(std::size_t shard) const {
+            const Shard& s = *shards_[shard];
+            return s.tail.load(std::memory_order_relaxed) - s.head.load(std::memory_order_relaxed);
+        }
+
+        // Waits for room when the ring is full; returns false if it had to
+        bool push(std::size_t shard, Item item) {
+            Shard& s = *shards_[shard];
+            uint64_t tail = s.tail.load(std::memory_order_relaxed);
+            bool waited = false;
+            while (tail - s.head.load(std::memory_order_acquire) >= capacity_) {
+                waited = true;
+                std::this_thread::yield();
+            }
+
+            s.slots[tail & (capacity_ - 1)] = std::move(item);
+            // seq_cst store/load pair with the worker's sleeping/tail pair: either it sees
+            // the new tail or we see it asleep
+            s.tail.store(tail + 1);
+            if (s.sleeping.load()) {
+                {
+                    std::lock_guard<std::mutex> lock(s.mtx);
+                }
+                s.cv.notify_one();
+            }
+            return !waited;
+        }
+    private:
+        void work(std::size_t index) {
+            Shard& s = *shards_[index];
+            uint64_t head = 0;
+            for (;;) {
+                uint64_t tail = s.tail.load(std::memory_order_acquire);
+                for (int spin = 0; tail == head && spin < kSpins; ++spin) {
+                    std::this_thread::yield();
+                    tail = s.tail.load(std::memory_order_acquire);
+                }
+
+                if (tail == head) {
+                    std::unique_lock<std::mutex> lock(s.mtx);
+                    s.sleeping.store(true);
+                    s.cv.wait(lock, [&] { return s.tail.load() != head || stop_.load(); });
+                    s.sleeping.store(false);
+                    tail = s.tail.load(std::memory_order_acquire);
+                    if (tail == head) return;  // stopped with nothing left
+                }
+
+                for (; head != tail; ++head) {
+                    Item& item = s.slots[head & (capacity_ - 1)];
+                    handler_(index, item);
+                    item = Item{};
+                    s.head.store(head + 1, std::memory_order_release);
+                }
+                if (drained_) drained_(index);
+            }
+        }
+    };
+}
@@ -0,0 +1,265 @@
+#pragma once
+#include "core/types.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace poly {
+    enum class BarPeriod {
+        SECOND,
+        MINUTE
+    };
+
+    struct Bar {
+        uint64_t start_ms = 0;  // bucket start in exchange time
+        double open = 0.0;
+        double high = 0.0;
+        double low = 0.0;
+        double close = 0.0;
+        double volume = 0.0;
+        double notional = 0.0;  // sum of price * size
+        double buy_volume = 0.0;
+        double sell_volume = 0.0;
+        uint32_t trades = 0;
+
+        double vwap() const { return volume > 0.0 ? notional / volume : close; }
+    };
+
+    struct PriceVolume {
+        double price;
+        double volume;
+    };
+
+    // Volume that traded outside a bucket's histogram range, kept apart so no price level
+    // is credited with it
+    struct OutOfRangeVolume {
+        double below = 0.0;
+        double above = 0.0;
+    };
+
+    // Price axis of the per-bucket volume histogram. Anchored histograms centre their
+    // bins on the first trade of each bucket, for venues whose price is unbounded; trades
+    // beyond the bins count as OutOfRangeVolume.
+    struct HistogramSpec {
+        double tick;
+        uint32_t bins;
+        bool anchored;
+    };
+
+    // Ring of fixed-width buckets for one key. Memory is allocated once; a trade lands in
+    // bucket (ts / width) % capacity, which is recycled when a newer period reaches it.
+    class TradeSeries {
+        uint64_t width_ms_;
+        std::size_t capacity_;
+        HistogramSpec spec_;
+
+        std::vector<Bar> bars_;
+        std::vector<double> hist_;        // capacity_ rows of spec_.bins volumes
+        std::vector<int64_t> hist_base_;  // tick index of bin 0, per bucket
+        std::vector<OutOfRangeVolume> outside_;  // per bucket
+        uint64_t latest_ = 0;             // newest bucket number seen
+        bool empty_ = true;
+    public:
+        TradeSeries(uint64_t width_ms, std::size_t capacity, HistogramSpec spec)
+            : width_ms_(width_ms), capacity_(std::max<std::size_t>(capacity, 1)), spec_(spec),
+              bars_(capacity_), hist_(capacity_ * spec.bins, 0.0), hist_base_(capacity_, 0), outside_(capacity_) {}
+
+        // Returns false for trades older than the ring
+        bool add(uint64_t ts_ms, double price, double size, Side side) {
+            uint64_t bucket = ts_ms / width_ms_;
+            if (!empty_ && bucket + capacity_ <= latest_) return false;
+
+            std::size_t slot = bucket % capacity_;
+            Bar& bar = bars_[slot];
+            double* row = &hist_[slot * spec_.bins];
+            int64_t tick = std::llround(price / spec_.tick);
+
+            if (bar.trades == 0 || bar.start_ms != bucket * width_ms_) {
+                bar = Bar{};
+                bar.start_ms = bucket * width_ms_;
+                bar.open = bar.high = bar.low = price;
+                std::fill(row, row + spec_.bins, 0.0);
+                outside_[slot] = {};
+                hist_base_[slot] = spec_.anchored ? tick - spec_.bins / 2 : 0;
+            }
+
+            if (empty_ || bucket > latest_) latest_ = bucket;
+            empty_ = false;
+
+            bar.high = std::max(bar.high, price);
+            bar.low = std::min(bar.low, price);
+            bar.close = price;
+            bar.volume += size;
+            bar.notional += price * size;
+            if (side == Side::BUY) bar.buy_volume += size;
+            else if (side == Side::SELL) bar.sell_volume += size;
+            ++bar.trades;
+
+            int64_t bin = tick - hist_base_[slot];
+            if (bin < 0) outside_[slot].below += size;
+            else if (bin >= spec_.bins) outside_[slot].above += size;
+            else row[bin] += size;
+            return true;
+        }
+
+        // Bars of the last n periods ending at the newest trade, oldest first.
+        // Periods without trades are omitted.
+        std::vector<Bar> last(std::size_t n) const {
+            std::vector<Bar> result;
+            for_each_bucket(n, [&](std::size_t slot) { result.push_back(bars_[slot]); });
+            return result;
+        }
+
+        // Volume traded at each price over the last n periods, ascending by price
+        std::vector<PriceVolume> histogram(std::size_t n) const {
+            std::map<int64_t, double> merged;
+            for_each_bucket(n, [&](std::size_t slot) {
+                const double* row = &hist_[slot * spec_.bins];
+                for (uint32_t b = 0; b < spec_.bins; ++b) {
+                    if (row[b] > 0.0) merged[hist_base_[slot] + b] += row[b];
+                }
+            });
+
+            // Sub-unit ticks divide by the whole number of ticks per unit, so 31 ticks of 0.001
+            // come out as 0.031 and not 0.031000000000000003
+            double per_unit = std::round(1.0 / spec_.tick);
+            std::vector<PriceVolume> result;
+            result.reserve(merged.size());
+            for (const auto& [tick, volume] : merged) {
+                double price = spec_.tick < 1.0 ? static_cast<double>(tick) / per_unit
+                                                : static_cast<double>(tick) * spec_.tick;
+                result.push_back({price, volume});
+            }
+            return result;
+        }
+
+        // Volume over the last n periods that histogram() leaves out
+        OutOfRangeVolume out_of_range(std::size_t n) const {
+            OutOfRangeVolume total;
+            for_each_bucket(n, [&](std::size_t slot) {
+                total.below += outside_[slot].below;
+                total.above += outside_[slot].above;
+            });
+            return total;
+        }
+    private:
+        template <class F>
+        void for_each_bucket(std::size_t n, F&& fn) const {
+            if (empty_) return;
+            n = std::min(n, capacity_);
+            uint64_t first = latest_ + 1 >= n ? latest_ + 1 - n : 0;
+            for (uint64_t bucket = first; bucket <= latest_; ++bucket) {
+                std::size_t slot = bucket % capacity_;
+                const Bar& bar = bars_[slot];
+                if (bar.trades != 0 && bar.start_ms == bucket * width_ms_) fn(slot);
+            }
+        }
+    };
+
+    // Incremental trade-tape aggregation over the MarketEvent stream: 1s and 1m OHLCV,
+    // VWAP, trade counts and price-volume histograms per asset and per venue.
+    class TradeAggregator {
+    public:
+        struct Config {
+            std::size_t second_buckets = 300;  // 5 minutes of 1s bars
+            std::size_t minute_buckets = 240;  // 4 hours of 1m bars
+        };
+
+        TradeAggregator() : TradeAggregator(Config{}) {}
+
+        explicit TradeAggregator(Config cfg)
+            : cfg_(cfg),
+              venues_{make_series(Venue::BINANCE), make_series(Venue::POLYMARKET)} {}
+
+        void on_event(const MarketEvent& evt) {
+            if (evt.size <= 0.0) return;
+            uint64_t ts = evt.timestamp_exch != 0 ? evt.timestamp_exch : evt.timestamp_recv;
+
+            std::lock_guard<std::mutex> lock(mtx_);
+            auto it = symbols_.find(evt.symbol);
+            if (it == symbols_.end()) it = symbols_.emplace(evt.symbol, make_series(evt.venue)).first;
+
+            it->second.add(ts, evt.price, evt.size, evt.side);
+            venues_[venue_index(evt.venue)].add(ts, evt.price, evt.size, evt.side);
+        }
+
+        std::vector<Bar> last(const std::string& symbol, BarPeriod period, std::size_t n) const {
+            std::lock_guard<std::mutex> lock(mtx_);
+            auto it = symbols_.find(symbol);
+            if (it == symbols_.end()) return {};
+            return it->second.get(period).last(n);
+        }
+
+        std::vector<Bar> last(Venue venue, BarPeriod period, std::size_t n) const {
+            std::lock_guard<std::mutex> lock(mtx_);
+            return venues_[venue_index(venue)].get(period).last(n);
+        }
+
+        std::vector<PriceVolume> volume_at_price(const std::string& symbol, BarPeriod period, std::size_t n) const {
+            std::lock_guard<std::mutex> lock(mtx_);
+            auto it = symbols_.find(symbol);
+            if (it == symbols_.end()) return {};
+            return it->second.get(period).histogram(n);
+        }
+
+        std::vector<PriceVolume> volume_at_price(Venue venue, BarPeriod period, std::size_t n) const {
+            std::lock_guard<std::mutex> lock(mtx_);
+            return venues_[venue_index(venue)].get(period).histogram(n);
+        }
+
+        OutOfRangeVolume volume_out_of_range(const std::string& symbol, BarPeriod period, std::size_t n) const {
+            std::lock_guard<std::mutex> lock(mtx_);
+            auto it = symbols_.find(symbol);
+            if (it == symbols_.end()) return {};
+            return it->second.get(period).out_of_range(n);
+        }
+
+        OutOfRangeVolume volume_out_of_range(Venue venue, BarPeriod period, std::size_t n) const {
+            std::lock_guard<std::mutex> lock(mtx_);
+            return venues_[venue_index(venue)].get(period).out_of_range(n);
+        }
+    private:
+        struct Series {
+            TradeSeries seconds;
+            TradeSeries minutes;
+
+            void add(uint64_t ts_ms, double price, double size, Side side) {
+                seconds.add(ts_ms, price, size, side);
+                minutes.add(ts_ms, price, size, side);
+            }
+
+            const TradeSeries& get(BarPeriod period) const {
+                return period == BarPeriod::SECOND ? seconds : minutes;
+            }
+        };
+
+        static HistogramSpec histogram_spec(Venue venue) {
+            // Polymarket prices live in [0, 1]; markets switch to 0.001 ticks near 0 and 1, so
+            // the grid is the finest tick and every print keeps its exact price. BTC moves on
+            // a dollar grid
+            if (venue == Venue::POLYMARKET) return {0.001, 1001, false};
+            return {1.0, 256, true};
+        }
+
+        static std::size_t venue_index(Venue venue) {
+            return venue == Venue::POLYMARKET ? 1 : 0;
+        }
+
+        Series make_series(Venue venue) const {
+            HistogramSpec spec = histogram_spec(venue);
+            return Series{TradeSeries(1000, cfg_.second_buckets, spec),
+                          TradeSeries(60000, cfg_.minute_buckets, spec)};
+        }
+
+        Config cfg_;
+        std::unordered_map<std::string, Series> symbols_;
+        Series venues_[2];
+        mutable std::mutex mtx_;
+    };
+}
@@ -1,6 +1,7 @@
 #pragma once
 #include <cstdint>
 #include <chrono>
+#include <cstdio>
 #include <string>
 
 namespace poly {
@@ -20,6 +21,8 @@ namespace poly {
         std::string symbol;
         uint64_t timestamp_exch;
         uint64_t timestamp_recv;
+        uint64_t timestamp_recv_ns = 0;    // frame handed to the feed, system clock
+        uint64_t timestamp_kernel_ns = 0;  // kernel receive time of that frame, 0 without SO_TIMESTAMPING
 
         double price;
         double size;
@@ -33,8 +36,31 @@ namespace poly {
         std::string original_payload;
     };
 
+    struct BookTop {
+        double best_bid = 0.0;
+        double best_ask = 1.0;
+        double bid_depth = 0.0;
+        double ask_depth = 0.0;
+        uint64_t timestamp_recv = 0;
+    };
+
     inline uint64_t now_ms() {
         using namespace std::chrono;
         return duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
     }
+
+    inline uint64_t now_ns() {
+        using namespace std::chrono;
+        return duration_cast<nanoseconds>(system_clock::now().time_since_epoch()).count();
+    }
+
+    // YYYY-MM-DD of a millisecond timestamp, UTC
+    inline std::string utc_date(uint64_t timestamp_ms) {
+        using namespace std::chrono;
+        year_month_day ymd{sys_days{days{static_cast<int64_t>(timestamp_ms / 86400000)}}};
+        char day[16];
+        std::snprintf(day, sizeof(day), "%04d-%02u-%02u", static_cast<int>(ymd.year()),
+            static_cast<unsigned>(ymd.month()), static_cast<unsigned>(ymd.day()));
+        return day;
+    }
 }
\ No newline at end of file
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace poly {
+    // Fixed pool where every worker owns a deque: it pops its own newest task and, when
+    // empty, steals the oldest task of another worker. Meant for batches of independent,
+    // unevenly sized jobs submitted up front, followed by wait().
+    class WorkStealingPool {
+        struct alignas(64) Queue {
+            std::mutex mtx;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        std::vector<std::unique_ptr<Queue>> queues_;
+        std::vector<std::thread> threads_;
+
+        std::atomic<std::size_t> queued_{0};   // submitted, not yet picked up
+        std::atomic<std::size_t> pending_{0};  // submitted, not yet finished
+        std::atomic<std::size_t> next_{0};
+        bool stop_ = false;
+
+        std::mutex wake_mtx_;
+        std::condition_variable work_cv_;
+        std::condition_variable idle_cv_;
+    public:
+        explicit WorkStealingPool(std::size_t threads = std::thread::hardware_concurrency()) {
+            threads = std::max<std::size_t>(threads, 1);
+            for (std::size_t i = 0; i < threads; ++i) queues_.push_back(std::make_unique<Queue>());
+            for (std::size_t i = 0; i < threads; ++i) threads_.emplace_back([this, i] { work(i); });
+        }
+
+        WorkStealingPool(const WorkStealingPool&) = delete;
+        WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+        ~WorkStealingPool() {
+            {
+                std::lock_guard<std::mutex> lock(wake_mtx_);
+                stop_ = true;
+            }
+            work_cv_.notify_all();
+            for (auto& t : threads_) t.join();
+        }
+
+        std::size_t size() const { return threads_.size(); }
+
+        void submit(std::function<void()> task) {
+            Queue& q = *queues_[next_.fetch_add(1, std::memory_order_relaxed) % queues_.size()];
+            pending_.fetch_add(1, std::memory_order_relaxed);
+            {
+                // Counted before it is visible so a thief can never take queued_ below zero
+                std::lock_guard<std::mutex> lock(wake_mtx_);
+                queued_.fetch_add(1, std::memory_order_release);
+            }
+            {
+                std::lock_guard<std::mutex> lock(q.mtx);
+                q.tasks.push_back(std::move(task));
+            }
+            work_cv_.notify_one();
+        }
+
+        // Blocks until every submitted task has finished
+        void wait() {
+            std::unique_lock<std::mutex> lock(wake_mtx_);
+            idle_cv_.wait(lock, [this] { return pending_.load(std::memory_order_acquire) == 0; });
+        }
+    private:
+        bool take(std::size_t self, std::function<void()>& task) {
+            {
+                Queue& own = *queues_[self];
+                std::lock_guard<std::mutex> lock(own.mtx);
+                if (!own.tasks.empty()) {
+                    task = std::move(own.tasks.back());
+                    own.tasks.pop_back();
+                    return true;
+                }
+            }
+            for (std::size_t k = 1; k < queues_.size(); ++k) {
+                Queue& victim = *queues_[(self + k) % queues_.size()];
+                std::lock_guard<std::mutex> lock(victim.mtx);
+                if (!victim.tasks.empty()) {
+                    task = std::move(victim.tasks.front());
+                    victim.tasks.pop_front();
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void work(std::size_t self) {
+            std::function<void()> task;
+            for (;;) {
+                if (take(self, task)) {
+                    queued_.fetch_sub(1, std::memory_order_relaxed);
+                    task();
+                    task = nullptr;
+                    if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                        std::lock_guard<std::mutex> lock(wake_mtx_);
+                        idle_cv_.notify_all();
+                    }
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> lock(wake_mtx_);
+                work_cv_.wait(lock, [this] { return stop_ || queued_.load(std::memory_order_acquire) > 0; });
+                if (stop_ && queued_.load(std::memory_order_acquire) == 0) return;
+            }
+        }
+    };
+}
@@ -6,6 +6,10 @@
 namespace poly {
     // Engine tells the feed what it should to do when data arrive
     using EventCallback = std::function<void(const MarketEvent&)>;
+    // Fired after every book change with the new top of book of that asset
+    using BookCallback = std::function<void(const std::string& asset, const BookTop&)>;
+    // Every websocket frame as received, for capture and replay
+    using RawCallback = std::function<void(uint64_t timestamp_recv, const std::string& frame)>;
 
     class IFeedClient {
     public:
@@ -0,0 +1,94 @@
+#pragma once
+#include "core/orderbook.hpp"
+#include "core/types.hpp"
+
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+
+// Parsing of Polymarket market-channel messages, shared by the live feed and the
+// offline tools so that both build books the same way.
+namespace poly {
+    struct LevelUpdate {
+        bool is_bid;
+        double price;
+        double size;  // new size at the level, 0 removes it
+    };
+
+    // One asset's share of a `book` snapshot or of a `price_change` message
+    struct BookUpdate {
+        std::string asset;
+        bool snapshot = false;  // replaces the whole book
+        uint64_t timestamp_exch = 0;
+        std::vector<LevelUpdate> levels;
+    };
+
+    inline uint64_t parse_timestamp(const nlohmann::json& item) {
+        return std::stoull(item.value("timestamp", "0"));
+    }
+
+    inline bool parse_book(const nlohmann::json& item, BookUpdate& out) {
+        try {
+            out.asset = item["asset_id"];
+            out.snapshot = true;
+            out.timestamp_exch = parse_timestamp(item);
+            out.levels.clear();
+            for (const char* side : {"bids", "asks"}) {
+                if (!item.contains(side)) continue;
+                bool is_bid = side[0] == 'b';
+                for (const auto& level : item[side]) {
+                    out.levels.push_back({is_bid, std::stod(level.value("price", "0")),
+                                          std::stod(level.value("size", "0"))});
+                }
+            }
+            return true;
+        } catch (...) {
+            return false;
+        }
+    }
+
+    // Changes come out grouped per asset, each group in message order
+    inline bool parse_price_change(const nlohmann::json& item, std::vector<BookUpdate>& out) {
+        try {
+            uint64_t ts = parse_timestamp(item);
+            for (const auto& chg : item["price_changes"]) {
+                std::string asset = chg["asset_id"];
+                BookUpdate* upd = nullptr;
+                for (auto& u : out) {
+                    if (u.asset == asset) { upd = &u; break; }
+                }
+                if (!upd) {
+                    upd = &out.emplace_back();
+                    upd->asset = std::move(asset);
+                    upd->timestamp_exch = ts;
+                }
+                upd->levels.push_back({chg["side"] == "BUY", std::stod(chg.value("price", "0")),
+                                       std::stod(chg.value("size", "0"))});
+            }
+            return true;
+        } catch (...) {
+            return false;
+        }
+    }
+
+    inline bool parse_trade(const nlohmann::json& item, MarketEvent& evt) {
+        try {
+            evt.venue = Venue::POLYMARKET;
+            evt.symbol = item.value("asset_id", "unknown");
+            evt.price = std::stod(item.value("price", "0"));
+            evt.size = std::stod(item.value("size", "0"));
+            evt.timestamp_exch = parse_timestamp(item);
+            evt.side = (item.value("side", "") == "BUY") ? Side::BUY : Side::SELL;
+            return true;
+        } catch (...) {
+            return false;
+        }
+    }
+
+    inline void apply_update(Orderbook& book, const BookUpdate& upd) {
+        if (upd.snapshot) book.clear();
+        for (const auto& level : upd.levels) {
+            book.update(level.is_bid, level.price, level.size);
+        }
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <spdlog/spdlog.h>
+#include <cerrno>
+#include <cstring>
+
+#include <linux/net_tstamp.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+namespace poly {
+    // Socket options applied to a feed connection right after connect. The defaults leave
+    // the kernel settings alone; low_latency() is the profile for colocated trading.
+    struct SocketProfile {
+        bool no_delay = false;
+        int rcvbuf_bytes = 0;        // 0 keeps the kernel default and receive buffer autotuning
+        int busy_poll_us = 0;        // SO_BUSY_POLL; raising it above net.core.busy_read needs CAP_NET_ADMIN
+        bool quick_ack = false;      // the kernel drops TCP_QUICKACK on its own, it is re-armed after every read
+        bool rx_timestamps = false;  // software receive timestamps, read back by TimestampedStream
+
+        static SocketProfile low_latency() {
+            SocketProfile p;
+            p.no_delay = true;
+            p.rcvbuf_bytes = 4 << 20;
+            p.busy_poll_us = 50;
+            p.quick_ack = true;
+            p.rx_timestamps = true;
+            return p;
+        }
+    };
+
+    inline bool set_socket_option(int fd, int level, int name, int value, const char* what) {
+        if (::setsockopt(fd, level, name, &value, sizeof(value)) == 0) return true;
+        spdlog::warn("Socket: cannot set {}={}: {}", what, value, std::strerror(errno));
+        return false;
+    }
+
+    // Returns false if the kernel refused any option; the socket stays usable either way
+    inline bool apply_socket_profile(int fd, const SocketProfile& profile) {
+        bool ok = true;
+        if (profile.no_delay) ok &= set_socket_option(fd, IPPROTO_TCP, TCP_NODELAY, 1, "TCP_NODELAY");
+        if (profile.quick_ack) ok &= set_socket_option(fd, IPPROTO_TCP, TCP_QUICKACK, 1, "TCP_QUICKACK");
+        if (profile.busy_poll_us > 0) {
+            ok &= set_socket_option(fd, SOL_SOCKET, SO_BUSY_POLL, profile.busy_poll_us, "SO_BUSY_POLL");
+        }
+        if (profile.rcvbuf_bytes > 0) {
+            ok &= set_socket_option(fd, SOL_SOCKET, SO_RCVBUF, profile.rcvbuf_bytes, "SO_RCVBUF");
+            // The kernel doubles the request and caps it at net.core.rmem_max
+            int actual = 0;
+            socklen_t len = sizeof(actual);
+            if (::getsockopt(fd, SOL_SOCKET, SO_RCVBUF, &actual, &len) == 0 && actual < profile.rcvbuf_bytes) {
+                spdlog::warn("Socket: SO_RCVBUF is {} bytes, {} requested (raise net.core.rmem_max)",
+                    actual, profile.rcvbuf_bytes);
+            }
+        }
+        if (profile.rx_timestamps) {
+            ok &= set_socket_option(fd, SOL_SOCKET, SO_TIMESTAMPING,
+                SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE, "SO_TIMESTAMPING");
+        }
+        return ok;
+    }
+}
@@ -0,0 +1,153 @@
+#pragma once
+#include "feed /socket_profile.hpp"
+#include <boost/asio/async_result.hpp>
+#include <boost/beast/core.hpp>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <utility>
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+namespace poly {
+    // beast::tcp_stream with a SocketProfile applied on connect. When the profile asks for
+    // receive timestamps or quick acks, reads go through recvmsg() so the kernel receive
+    // time of the latest segment is kept and TCP_QUICKACK is re-armed; otherwise reads are
+    // forwarded untouched. Sits under ssl_stream, and next_layer() exposes the tcp_stream
+    // so beast::get_lowest_layer() keeps working for connect, timeouts and close.
+    //
+    // The recvmsg path waits for readiness only after a read returned EAGAIN, so the
+    // io_context has to be run by a single thread (see run_io).
+    class TimestampedStream {
+        boost::beast::tcp_stream stream_;
+        bool intercept_ = false;
+        bool quick_ack_ = false;
+        uint64_t last_receive_ns_ = 0;
+
+        template<class Buffers, class Handler>
+        class read_op : public boost::beast::async_base<Handler, boost::beast::tcp_stream::executor_type> {
+            TimestampedStream& s_;
+            Buffers buffers_;
+        public:
+            read_op(Handler&& handler, TimestampedStream& s, const Buffers& buffers)
+                : boost::beast::async_base<Handler, boost::beast::tcp_stream::executor_type>(
+                    std::move(handler), s.get_executor()),
+                s_(s), buffers_(buffers) {
+                (*this)({}, false);
+            }
+
+            void operator()(boost::beast::error_code ec, bool cont = true) {
+                std::size_t n = 0;
+                if (!ec && !s_.receive(buffers_, n, ec)) {
+                    s_.socket().async_wait(boost::asio::socket_base::wait_read, std::move(*this));
+                    return;
+                }
+                this->complete(cont, ec, n);
+            }
+        };
+    public:
+        using executor_type = boost::beast::tcp_stream::executor_type;
+        using next_layer_type = boost::beast::tcp_stream;
+        using lowest_layer_type = boost::asio::ip::tcp::socket;  // what ssl::stream builds its core on
+
+        template<class... Args>
+        explicit TimestampedStream(Args&&... args) : stream_(std::forward<Args>(args)...) {}
+
+        executor_type get_executor() noexcept { return stream_.get_executor(); }
+        next_layer_type& next_layer() noexcept { return stream_; }
+        const next_layer_type& next_layer() const noexcept { return stream_; }
+        lowest_layer_type& lowest_layer() noexcept { return stream_.socket(); }
+        const lowest_layer_type& lowest_layer() const noexcept { return stream_.socket(); }
+        boost::asio::ip::tcp::socket& socket() noexcept { return stream_.socket(); }
+
+        // Call on every new connection, the options do not survive a reconnect
+        bool apply(const SocketProfile& profile) {
+            intercept_ = profile.rx_timestamps || profile.quick_ack;
+            quick_ack_ = profile.quick_ack;
+            last_receive_ns_ = 0;
+            return apply_socket_profile(socket().native_handle(), profile);
+        }
+
+        // Kernel receive time (system clock) of the latest segment read, 0 when not available
+        uint64_t last_receive_ns() const { return last_receive_ns_; }
+
+        template<class MutableBufferSequence, class ReadHandler>
+        auto async_read_some(const MutableBufferSequence& buffers, ReadHandler&& handler) {
+            return boost::asio::async_initiate<ReadHandler, void(boost::beast::error_code, std::size_t)>(
+                [this](auto&& h, const MutableBufferSequence& b) {
+                    using handler_type = std::decay_t<decltype(h)>;
+                    if (!intercept_) {
+                        stream_.async_read_some(b, std::move(h));
+                        return;
+                    }
+                    read_op<MutableBufferSequence, handler_type>(std::move(h), *this, b);
+                },
+                handler, buffers);
+        }
+
+        template<class ConstBufferSequence, class WriteHandler>
+        auto async_write_some(const ConstBufferSequence& buffers, WriteHandler&& handler) {
+            return stream_.async_write_some(buffers, std::forward<WriteHandler>(handler));
+        }
+    private:
+        // False when nothing is buffered; ec and n are set otherwise
+        template<class Buffers>
+        bool receive(const Buffers& buffers, std::size_t& n, boost::beast::error_code& ec) {
+            constexpr std::size_t kMaxIov = 16;
+            iovec iov[kMaxIov];
+            std::size_t count = 0;
+            for (auto it = boost::asio::buffer_sequence_begin(buffers);
+                 it != boost::asio::buffer_sequence_end(buffers) && count < kMaxIov; ++it) {
+                boost::asio::mutable_buffer b = *it;
+                if (b.size() == 0) continue;
+                iov[count].iov_base = b.data();
+                iov[count].iov_len = b.size();
+                ++count;
+            }
+            if (count == 0) return true;
+
+            alignas(cmsghdr) char control[CMSG_SPACE(3 * sizeof(timespec))];
+            msghdr msg{};
+            msg.msg_iov = iov;
+            msg.msg_iovlen = count;
+            msg.msg_control = control;
+            msg.msg_controllen = sizeof(control);
+
+            ssize_t r;
+            do {
+                r = ::recvmsg(socket().native_handle(), &msg, MSG_DONTWAIT);
+            } while (r < 0 && errno == EINTR);
+
+            if (r < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) return false;
+                ec.assign(errno, boost::system::system_category());
+                return true;
+            }
+            if (r == 0) {
+                ec = boost::asio::error::eof;
+                return true;
+            }
+
+            for (cmsghdr* c = CMSG_FIRSTHDR(&msg); c; c = CMSG_NXTHDR(&msg, c)) {
+                if (c->cmsg_level != SOL_SOCKET || c->cmsg_type != SO_TIMESTAMPING) continue;
+                // scm_timestamping: [0] software, [1] deprecated, [2] hardware
+                timespec ts[3];
+                std::memcpy(ts, CMSG_DATA(c), sizeof(ts));
+                if (ts[0].tv_sec || ts[0].tv_nsec) {
+                    last_receive_ns_ = static_cast<uint64_t>(ts[0].tv_sec) * 1000000000ull + ts[0].tv_nsec;
+                }
+            }
+
+            if (quick_ack_) {
+                int one = 1;
+                ::setsockopt(socket().native_handle(), IPPROTO_TCP, TCP_QUICKACK, &one, sizeof(one));
+            }
+            n = static_cast<std::size_t>(r);
+            return true;
+        }
+    };
+}
@@ -0,0 +1,243 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace poly {
+    using MetricLabels = std::vector<std::pair<std::string, std::string>>;
+
+    // Process-wide metrics. Counters live in per-thread shards that only their owning
+    // thread writes (plain load/store, no lock prefix), and are summed when scraped.
+    // Gauges are last-value cells, each on its own cache line.
+    class MetricsRegistry {
+    public:
+        static constexpr uint32_t kMaxCounters = 1024;
+
+        struct alignas(64) ThreadShard {
+            std::atomic<uint64_t> values[kMaxCounters] = {};
+        };
+
+        struct alignas(64) GaugeCell {
+            std::atomic<double> value{0.0};
+        };
+
+        static MetricsRegistry& instance() {
+            static MetricsRegistry registry;
+            return registry;
+        }
+
+        static ThreadShard& local_shard() {
+            thread_local ThreadShard* shard = instance().add_shard();
+            return *shard;
+        }
+
+        // Registering the same name and labels twice returns the same slot
+        uint32_t counter_slot(const std::string& name, const std::string& help,
+                              const MetricLabels& labels, double scale = 1.0) {
+            std::lock_guard<std::mutex> lock(mtx_);
+            Series& s = series(name, help, "counter", labels);
+            if (s.slot == 0) {
+                if (next_counter_ >= kMaxCounters) return 0;
+                s.slot = next_counter_++;
+                s.scale = scale;
+            }
+            return s.slot;
+        }
+
+        GaugeCell* gauge_cell(const std::string& name, const std::string& help, const MetricLabels& labels) {
+            std::lock_guard<std::mutex> lock(mtx_);
+            Series& s = series(name, help, "gauge", labels);
+            if (!s.gauge) s.gauge = &gauges_.emplace_back();
+            return s.gauge;
+        }
+
+        uint32_t histogram_slots(const std::string& name, const std::string& help,
+                                 const MetricLabels& labels, const std::vector<double>& bounds, double scale) {
+            std::lock_guard<std::mutex> lock(mtx_);
+            Series& s = series(name, help, "histogram", labels);
+            if (s.slot == 0) {
+                // One slot per finite bound, then +Inf, then the sum
+                uint32_t needed = static_cast<uint32_t>(bounds.size()) + 2;
+                if (next_counter_ + needed > kMaxCounters) return 0;
+                s.slot = next_counter_;
+                s.bounds = bounds;
+                s.scale = scale;
+                next_counter_ += needed;
+            }
+            return s.slot;
+        }
+
+        // Prometheus text exposition format 0.0.4
+        std::string render() {
+            std::lock_guard<std::mutex> lock(mtx_);
+            std::ostringstream out;
+            out.precision(12);
+
+            for (const auto& [name, family] : families_) {
+                out << "# HELP " << name << " " << family.help << "\n";
+                out << "# TYPE " << name << " " << family.type << "\n";
+
+                for (const auto& [labels, s] : family.series) {
+                    if (family.type == "gauge") {
+                        out << name << braces(labels) << " " << s.gauge->value.load(std::memory_order_relaxed) << "\n";
+                    } else if (family.type == "counter") {
+                        if (s.slot == 0) continue;
+                        out << name << braces(labels) << " " << sum(s.slot) * s.scale << "\n";
+                    } else {
+                        if (s.slot == 0) continue;
+                        uint64_t cumulative = 0;
+                        for (std::size_t i = 0; i <= s.bounds.size(); ++i) {
+                            cumulative += sum(s.slot + static_cast<uint32_t>(i));
+                            std::ostringstream le;
+                            le.precision(12);
+                            if (i < s.bounds.size()) le << s.bounds[i] * s.scale;
+                            else le << "+Inf";
+                            out << name << "_bucket" << braces(join(labels, "le=\"" + le.str() + "\""))
+                                << " " << cumulative << "\n";
+                        }
+                        uint32_t sum_slot = s.slot + static_cast<uint32_t>(s.bounds.size()) + 1;
+                        out << name << "_sum" << braces(labels) << " " << sum(sum_slot) * s.scale << "\n";
+                        out << name << "_count" << braces(labels) << " " << cumulative << "\n";
+                    }
+                }
+            }
+            return out.str();
+        }
+    private:
+        struct Series {
+            uint32_t slot = 0;  // slot 0 is a write-only sink for registrations beyond capacity
+            double scale = 1.0;
+            GaugeCell* gauge = nullptr;
+            std::vector<double> bounds;
+        };
+
+        struct Family {
+            std::string help;
+            std::string type;
+            std::map<std::string, Series> series;  // keyed by rendered label set
+        };
+
+        MetricsRegistry() = default;
+
+        ThreadShard* add_shard() {
+            std::lock_guard<std::mutex> lock(mtx_);
+            // Shards outlive their threads so totals never go backwards
+            shards_.push_back(std::make_unique<ThreadShard>());
+            return shards_.back().get();
+        }
+
+        Series& series(const std::string& name, const std::string& help,
+                       const char* type, const MetricLabels& labels) {
+            Family& family = families_[name];
+            if (family.type.empty()) {
+                family.help = help;
+                family.type = type;
+            }
+            return family.series[format(labels)];
+        }
+
+        uint64_t sum(uint32_t slot) const {
+            uint64_t total = 0;
+            for (const auto& shard : shards_) {
+                total += shard->values[slot].load(std::memory_order_relaxed);
+            }
+            return total;
+        }
+
+        static std::string format(const MetricLabels& labels) {
+            std::string out;
+            for (const auto& [key, value] : labels) {
+                if (!out.empty()) out += ',';
+                out += key;
+                out += "=\"";
+                for (char c : value) {
+                    if (c == '\\' || c == '"') out += '\\';
+                    if (c == '\n') { out += "\\n"; continue; }
+                    out += c;
+                }
+                out += '"';
+            }
+            return out;
+        }
+
+        static std::string join(const std::string& labels, const std::string& extra) {
+            return labels.empty() ? extra : labels + "," + extra;
+        }
+
+        static std::string braces(const std::string& labels) {
+            return labels.empty() ? "" : "{" + labels + "}";
+        }
+
+        std::mutex mtx_;
+        std::vector<std::unique_ptr<ThreadShard>> shards_;
+        std::deque<GaugeCell> gauges_;
+        std::map<std::string, Family> families_;
+        uint32_t next_counter_ = 1;
+    };
+
+    class Counter {
+        uint32_t slot_ = 0;
+    public:
+        Counter() = default;
+        Counter(const std::string& name, const std::string& help, const MetricLabels& labels = {},
+                double scale = 1.0)
+            : slot_(MetricsRegistry::instance().counter_slot(name, help, labels, scale)) {}
+
+        void inc(uint64_t n = 1) const {
+            auto& v = MetricsRegistry::local_shard().values[slot_];
+            v.store(v.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+    };
+
+    class Gauge {
+        MetricsRegistry::GaugeCell* cell_ = nullptr;
+    public:
+        Gauge() = default;
+        Gauge(const std::string& name, const std::string& help, const MetricLabels& labels = {})
+            : cell_(MetricsRegistry::instance().gauge_cell(name, help, labels)) {}
+
+        void set(double v) const { if (cell_) cell_->value.store(v, std::memory_order_relaxed); }
+        void add(double v) const { if (cell_) cell_->value.fetch_add(v, std::memory_order_relaxed); }
+    };
+
+    // Fixed-bucket latency histogram, recorded in nanoseconds and exposed in seconds
+    class LatencyHistogram {
+        uint32_t slot_ = 0;
+        std::vector<uint64_t> bounds_ns_;
+    public:
+        LatencyHistogram() = default;
+        LatencyHistogram(const std::string& name, const std::string& help, const MetricLabels& labels = {},
+                         std::vector<uint64_t> bounds_ns = {1000, 5000, 10000, 50000, 100000, 500000,
+                                                            1000000, 5000000, 10000000, 50000000})
+            : bounds_ns_(std::move(bounds_ns)) {
+            std::vector<double> bounds(bounds_ns_.begin(), bounds_ns_.end());
+            slot_ = MetricsRegistry::instance().histogram_slots(name, help, labels, bounds, 1e-9);
+        }
+
+        void observe_ns(uint64_t ns) const {
+            if (slot_ == 0) return;
+            auto& shard = MetricsRegistry::local_shard();
+            std::size_t bucket = 0;
+            while (bucket < bounds_ns_.size() && ns > bounds_ns_[bucket]) ++bucket;
+
+            auto& b = shard.values[slot_ + bucket];
+            b.store(b.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            auto& s = shard.values[slot_ + bounds_ns_.size() + 1];
+            s.store(s.load(std::memory_order_relaxed) + ns, std::memory_order_relaxed);
+        }
+
+        void observe_since(std::chrono::steady_clock::time_point start) const {
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            observe_ns(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+        }
+    };
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include "metrics/metrics.hpp"
+
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <spdlog/spdlog.h>
+#include <memory>
+#include <string>
+
+namespace poly {
+    namespace beast = boost::beast;
+    namespace http = boost::beast::http;
+    namespace net = boost::asio;
+    using tcp = net::ip::tcp;
+
+    class MetricsSession : public std::enable_shared_from_this<MetricsSession> {
+        beast::tcp_stream stream_;
+        beast::flat_buffer buffer_;
+        http::request<http::empty_body> req_;
+        http::response<http::string_body> res_;
+    public:
+        explicit MetricsSession(tcp::socket&& socket) : stream_(std::move(socket)) {}
+
+        void run() {
+            do_read();
+        }
+    private:
+        void do_read() {
+            req_ = {};
+            stream_.expires_after(std::chrono::seconds(10));
+            http::async_read(stream_, buffer_, req_,
+                beast::bind_front_handler(&MetricsSession::on_read, shared_from_this()));
+        }
+
+        void on_read(beast::error_code ec, std::size_t) {
+            if (ec == http::error::end_of_stream) return close();
+            if (ec) return;
+
+            res_ = {};
+            res_.version(req_.version());
+            res_.keep_alive(req_.keep_alive());
+            res_.set(http::field::server, "PolyBot/1.0");
+
+            if (req_.method() == http::verb::get && req_.target() == "/metrics") {
+                res_.result(http::status::ok);
+                res_.set(http::field::content_type, "text/plain; version=0.0.4");
+                res_.body() = MetricsRegistry::instance().render();
+            } else {
+                res_.result(http::status::not_found);
+                res_.set(http::field::content_type, "text/plain");
+                res_.body() = "not found\n";
+            }
+            res_.prepare_payload();
+
+            http::async_write(stream_, res_,
+                beast::bind_front_handler(&MetricsSession::on_write, shared_from_this()));
+        }
+
+        void on_write(beast::error_code ec, std::size_t) {
+            if (ec) return;
+            if (!res_.keep_alive()) return close();
+            do_read();
+        }
+
+        void close() {
+            beast::error_code ec;
+            stream_.socket().shutdown(tcp::socket::shutdown_send, ec);
+        }
+    };
+
+    // Serves GET /metrics on the feeds' io_context; scrapes cost one render of the registry
+    class MetricsServer : public std::enable_shared_from_this<MetricsServer> {
+        net::io_context& ioc_;
+        tcp::acceptor acceptor_;
+        tcp::endpoint endpoint_;
+    public:
+        MetricsServer(net::io_context& ioc, unsigned short port, const std::string& address = "127.0.0.1")
+            : ioc_(ioc), acceptor_(net::make_strand(ioc)),
+              endpoint_(net::ip::make_address(address), port) {}
+
+        bool run() {
+            beast::error_code ec;
+            acceptor_.open(endpoint_.protocol(), ec);
+            if (!ec) acceptor_.set_option(net::socket_base::reuse_address(true), ec);
+            if (!ec) acceptor_.bind(endpoint_, ec);
+            if (!ec) acceptor_.listen(net::socket_base::max_listen_connections, ec);
+            if (ec) {
+                spdlog::error("Metrics endpoint {}:{} unavailable: {}",
+                    endpoint_.address().to_string(), endpoint_.port(), ec.message());
+                return false;
+            }
+
+            spdlog::info("Serving metrics on http://{}:{}/metrics",
+                endpoint_.address().to_string(), endpoint_.port());
+            do_accept();
+            return true;
+        }
+    private:
+        void do_accept() {
+            acceptor_.async_accept(net::make_strand(ioc_),
+                beast::bind_front_handler(&MetricsServer::on_accept, shared_from_this()));
+        }
+
+        void on_accept(beast::error_code ec, tcp::socket socket) {
+            if (ec) {
+                spdlog::warn("Metrics accept error: {}", ec.message());
+            } else {
+                std::make_shared<MetricsSession>(std::move(socket))->run();
+            }
+            do_accept();
+        }
+    };
+}
@@ -0,0 +1,440 @@
+#pragma once
+#include "core/types.hpp"
+
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace poly {
+    // On-disk layout of a .pcol file (little endian, everything 8-byte aligned):
+    //
+    //   FileHeader
+    //   ColumnDesc[column_count]
+    //   column blobs            one per column, blocks of block_rows values back to back
+    //   int64  first_key[block_count]                       sparse time index
+    //   uint64 block_offset[column_count][block_count]      offset of each block inside its blob
+    //
+    // Values are fixed point (value * 10^decimals). Inside a block the first value is stored
+    // as a zigzag varint and the rest as zigzag varint deltas, so any block decodes on its own.
+    // Column 0 is the time key and must be non-decreasing.
+    namespace pcol {
+        constexpr char kMagic[4] = {'P', 'C', 'O', 'L'};
+        constexpr uint32_t kVersion = 1;
+        constexpr std::size_t kNameLen = 32;
+
+        struct FileHeader {
+            char magic[4];
+            uint32_t version;
+            uint64_t row_count;
+            uint32_t column_count;
+            uint32_t block_rows;
+            uint64_t block_count;
+            uint64_t index_offset;
+        };
+
+        struct ColumnDesc {
+            char name[kNameLen];
+            uint32_t decimals;
+            uint32_t reserved;
+            uint64_t offset;
+            uint64_t length;
+        };
+
+        inline void put_varint(std::string& out, int64_t v) {
+            uint64_t z = (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+            while (z >= 0x80) {
+                out.push_back(static_cast<char>(z | 0x80));
+                z >>= 7;
+            }
+            out.push_back(static_cast<char>(z));
+        }
+
+        // Never reads at or past end; a varint cut off by end decodes from the bytes it has
+        inline int64_t get_varint(const uint8_t*& p, const uint8_t* end) {
+            uint64_t z = 0;
+            int shift = 0;
+            while (p < end) {
+                uint8_t b = *p++;
+                if (shift < 64) z |= static_cast<uint64_t>(b & 0x7f) << shift;
+                if (!(b & 0x80)) break;
+                shift += 7;
+            }
+            return static_cast<int64_t>(z >> 1) ^ -static_cast<int64_t>(z & 1);
+        }
+
+        inline double pow10(uint32_t decimals) {
+            double scale = 1.0;
+            for (uint32_t i = 0; i < decimals; ++i) scale *= 10.0;
+            return scale;
+        }
+    }
+
+    struct ColumnSpec {
+        std::string name;
+        uint32_t decimals;  // fixed-point precision; 0 for integers and timestamps
+    };
+
+    // Row range [begin, end) inside a file
+    struct RowRange {
+        std::size_t begin = 0;
+        std::size_t end = 0;
+
+        std::size_t size() const { return end - begin; }
+    };
+
+    // Decoded columns of one read, one contiguous array per requested column
+    struct ColumnBatch {
+        std::vector<std::string> names;
+        std::vector<std::vector<double>> values;
+
+        const std::vector<double>* find(const std::string& name) const {
+            for (std::size_t i = 0; i < names.size(); ++i) {
+                if (names[i] == name) return &values[i];
+            }
+            return nullptr;
+        }
+    };
+
+    // Builds a .pcol file in memory one row at a time; write() flushes it to disk
+    class ColumnWriter {
+        std::vector<ColumnSpec> specs_;
+        std::vector<double> scales_;
+        uint32_t block_rows_;
+
+        std::vector<std::string> blobs_;
+        std::vector<std::vector<uint64_t>> block_offsets_;
+        std::vector<int64_t> previous_;
+        std::vector<int64_t> first_key_;
+        uint64_t rows_ = 0;
+    public:
+        explicit ColumnWriter(std::vector<ColumnSpec> specs, uint32_t block_rows = 4096)
+            : specs_(std::move(specs)), block_rows_(std::max<uint32_t>(block_rows, 1)),
+              blobs_(specs_.size()), block_offsets_(specs_.size()), previous_(specs_.size(), 0) {
+            for (const auto& spec : specs_) scales_.push_back(pcol::pow10(spec.decimals));
+        }
+
+        uint64_t rows() const { return rows_; }
+
+        // row holds one value per column, in spec order
+        bool append(const std::vector<double>& row) {
+            if (row.size() != specs_.size()) return false;
+            return append(row.data());
+        }
+
+        // row points at one value per column, in spec order
+        bool append(const double* row) {
+            if (specs_.empty()) return false;
+
+            int64_t key = std::llround(row[0] * scales_[0]);
+            if (rows_ > 0 && key < previous_[0]) return false;
+
+            bool block_start = rows_ % block_rows_ == 0;
+            if (block_start) first_key_.push_back(key);
+
+            for (std::size_t c = 0; c < specs_.size(); ++c) {
+                int64_t v = std::llround(row[c] * scales_[c]);
+                if (block_start) {
+                    block_offsets_[c].push_back(blobs_[c].size());
+                    pcol::put_varint(blobs_[c], v);
+                } else {
+                    pcol::put_varint(blobs_[c], v - previous_[c]);
+                }
+                previous_[c] = v;
+            }
+            ++rows_;
+            return true;
+        }
+
+        bool write(const std::string& path) const {
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            if (!out) {
+                spdlog::error("Column store: cannot create {}", path);
+                return false;
+            }
+
+            std::vector<pcol::ColumnDesc> descs(specs_.size());
+            uint64_t offset = sizeof(pcol::FileHeader) + sizeof(pcol::ColumnDesc) * specs_.size();
+            for (std::size_t c = 0; c < specs_.size(); ++c) {
+                std::memset(&descs[c], 0, sizeof(pcol::ColumnDesc));
+                std::snprintf(descs[c].name, pcol::kNameLen, "%s", specs_[c].name.c_str());
+                descs[c].decimals = specs_[c].decimals;
+                descs[c].offset = offset;
+                descs[c].length = blobs_[c].size();
+                offset += align8(blobs_[c].size());
+            }
+
+            pcol::FileHeader header{};
+            std::memcpy(header.magic, pcol::kMagic, sizeof(header.magic));
+            header.version = pcol::kVersion;
+            header.row_count = rows_;
+            header.column_count = static_cast<uint32_t>(specs_.size());
+            header.block_rows = block_rows_;
+            header.block_count = first_key_.size();
+            header.index_offset = offset;
+
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char*>(descs.data()), sizeof(pcol::ColumnDesc) * descs.size());
+            static const char padding[8] = {};
+            for (const auto& blob : blobs_) {
+                out.write(blob.data(), static_cast<std::streamsize>(blob.size()));
+                out.write(padding, static_cast<std::streamsize>(align8(blob.size()) - blob.size()));
+            }
+            out.write(reinterpret_cast<const char*>(first_key_.data()),
+                static_cast<std::streamsize>(sizeof(int64_t) * first_key_.size()));
+            for (const auto& offsets : block_offsets_) {
+                out.write(reinterpret_cast<const char*>(offsets.data()),
+                    static_cast<std::streamsize>(sizeof(uint64_t) * offsets.size()));
+            }
+
+            if (!out) {
+                spdlog::error("Column store: write to {} failed", path);
+                return false;
+            }
+            return true;
+        }
+    private:
+        static uint64_t align8(uint64_t n) { return (n + 7) & ~uint64_t{7}; }
+    };
+
+    // Read-only, mmap'ed view of a .pcol file. Seeks by time through the sparse block
+    // index and decodes only the blocks and columns a query touches.
+    class ColumnReader {
+        std::string path_;
+        void* base_ = nullptr;
+        std::size_t size_ = 0;
+
+        const pcol::FileHeader* header_ = nullptr;
+        const pcol::ColumnDesc* columns_ = nullptr;
+        const int64_t* first_key_ = nullptr;
+        const uint64_t* block_offsets_ = nullptr;
+    public:
+        ColumnReader() = default;
+        ColumnReader(const ColumnReader&) = delete;
+        ColumnReader& operator=(const ColumnReader&) = delete;
+
+        ~ColumnReader() { close(); }
+
+        bool open(const std::string& path) {
+            close();
+            path_ = path;
+
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) {
+                spdlog::error("Column store: cannot open {}: {}", path, std::strerror(errno));
+                return false;
+            }
+            struct stat st{};
+            if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(pcol::FileHeader)) {
+                spdlog::error("Column store: {} is truncated", path);
+                ::close(fd);
+                return false;
+            }
+            size_ = static_cast<std::size_t>(st.st_size);
+            void* base = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+            ::close(fd);
+            if (base == MAP_FAILED) {
+                spdlog::error("Column store: mmap of {} failed: {}", path, std::strerror(errno));
+                return false;
+            }
+            base_ = base;
+
+            const char* bytes = static_cast<const char*>(base_);
+            header_ = reinterpret_cast<const pcol::FileHeader*>(bytes);
+            if (std::memcmp(header_->magic, pcol::kMagic, sizeof(pcol::kMagic)) != 0
+                || header_->version != pcol::kVersion) {
+                spdlog::error("Column store: {} is not a v{} column file", path, pcol::kVersion);
+                close();
+                return false;
+            }
+
+            if (!validate(path)) {
+                close();
+                return false;
+            }
+            ::madvise(base_, size_, MADV_SEQUENTIAL);
+            return true;
+        }
+
+        void close() {
+            if (base_) ::munmap(base_, size_);
+            base_ = nullptr;
+            header_ = nullptr;
+        }
+
+        bool is_open() const { return base_ != nullptr; }
+        std::size_t rows() const { return header_ ? header_->row_count : 0; }
+        std::size_t column_count() const { return header_ ? header_->column_count : 0; }
+        std::string column_name(std::size_t c) const { return std::string(columns_[c].name); }
+
+        int column_index(const std::string& name) const {
+            for (std::size_t c = 0; c < column_count(); ++c) {
+                if (name == columns_[c].name) return static_cast<int>(c);
+            }
+            return -1;
+        }
+
+        // Rows whose time key lies in [from, to), in O(log blocks + block_rows)
+        RowRange find_range(int64_t from, int64_t to) const {
+            if (!header_ || header_->row_count == 0 || from >= to) return {};
+            return {lower_bound(from), lower_bound(to)};
+        }
+
+        RowRange all() const { return {0, rows()}; }
+
+        std::vector<int64_t> read_raw(std::size_t column, RowRange range) const {
+            std::vector<int64_t> out(range.size());
+            decode(column, range, out.data());
+            return out;
+        }
+
+        std::vector<double> read_values(std::size_t column, RowRange range) const {
+            std::vector<int64_t> raw = read_raw(column, range);
+            std::vector<double> out(raw.size());
+            // Divide rather than multiply by the inverse: the result is then the double nearest
+            // to the decimal that was stored, the same one std::stod gives for the original text
+            double scale = pcol::pow10(columns_[column].decimals);
+            for (std::size_t i = 0; i < raw.size(); ++i) out[i] = static_cast<double>(raw[i]) / scale;
+            return out;
+        }
+
+        // Decodes only the named columns over the range; unknown names are skipped
+        ColumnBatch read(RowRange range, const std::vector<std::string>& names) const {
+            ColumnBatch batch;
+            for (const auto& name : names) {
+                int c = column_index(name);
+                if (c < 0) {
+                    spdlog::warn("Column store: {} has no column {}", path_, name);
+                    continue;
+                }
+                batch.names.push_back(name);
+                batch.values.push_back(read_values(static_cast<std::size_t>(c), range));
+            }
+            return batch;
+        }
+    private:
+        // Every count, offset and length the readers rely on must agree with the file size;
+        // sizes are compared by division so corrupt counts cannot overflow the checks
+        bool validate(const std::string& path) {
+            const char* bytes = static_cast<const char*>(base_);
+            const pcol::FileHeader& h = *header_;
+            auto reject = [&](const char* what) {
+                spdlog::error("Column store: {} is corrupt: {}", path, what);
+                return false;
+            };
+
+            if (h.block_rows == 0) return reject("block_rows is 0");
+            if (h.column_count == 0) return reject("no columns");
+            std::size_t after_header = size_ - sizeof(pcol::FileHeader);
+            if (h.column_count > after_header / sizeof(pcol::ColumnDesc)) return reject("column table past end of file");
+
+            uint64_t expected_blocks = h.row_count / h.block_rows + (h.row_count % h.block_rows != 0);
+            if (h.block_count != expected_blocks) return reject("block count does not match row count");
+
+            if (h.index_offset > size_ || h.index_offset % alignof(uint64_t) != 0) return reject("bad index offset");
+            uint64_t index_entries = h.block_count == 0 ? 0 : 1 + static_cast<uint64_t>(h.column_count);
+            if (index_entries != 0 && h.block_count > (size_ - h.index_offset) / sizeof(uint64_t) / index_entries) {
+                return reject("truncated index");
+            }
+
+            columns_ = reinterpret_cast<const pcol::ColumnDesc*>(bytes + sizeof(pcol::FileHeader));
+            first_key_ = reinterpret_cast<const int64_t*>(bytes + h.index_offset);
+            block_offsets_ = reinterpret_cast<const uint64_t*>(first_key_ + h.block_count);
+
+            for (std::size_t c = 0; c < h.column_count; ++c) {
+                const pcol::ColumnDesc& col = columns_[c];
+                if (col.offset > size_ || col.length > size_ - col.offset) return reject("column data past end of file");
+                for (uint64_t b = 0; b < h.block_count; ++b) {
+                    if (block_offsets_[c * h.block_count + b] >= col.length) return reject("block offset past column data");
+                }
+            }
+            return true;
+        }
+
+        const uint8_t* block_ptr(std::size_t column, std::size_t block) const {
+            return static_cast<const uint8_t*>(base_) + columns_[column].offset
+                + block_offsets_[column * header_->block_count + block];
+        }
+
+        const uint8_t* column_end(std::size_t column) const {
+            return static_cast<const uint8_t*>(base_) + columns_[column].offset + columns_[column].length;
+        }
+
+        void decode(std::size_t column, RowRange range, int64_t* out) const {
+            if (range.size() == 0) return;
+            const uint32_t block_rows = header_->block_rows;
+
+            std::size_t row = range.begin - range.begin % block_rows;
+            const uint8_t* p = block_ptr(column, row / block_rows);
+            const uint8_t* end = column_end(column);
+            int64_t v = 0;
+            for (; row < range.end; ++row) {
+                int64_t d = pcol::get_varint(p, end);
+                v = row % block_rows == 0 ? d : v + d;
+                if (row >= range.begin) *out++ = v;
+            }
+        }
+
+        // First row whose key is >= key
+        std::size_t lower_bound(int64_t key) const {
+            const uint64_t blocks = header_->block_count;
+            // Last block starting strictly below key; the answer lies in it or at the next block start
+            const int64_t* it = std::lower_bound(first_key_, first_key_ + blocks, key);
+            if (it == first_key_) return 0;
+            std::size_t block = static_cast<std::size_t>(it - first_key_) - 1;
+
+            const uint32_t block_rows = header_->block_rows;
+            std::size_t row = block * block_rows;
+            std::size_t end = std::min<std::size_t>(row + block_rows, header_->row_count);
+            const uint8_t* p = block_ptr(0, block);
+            const uint8_t* blob_end = column_end(0);
+            int64_t v = 0;
+            for (; row < end; ++row) {
+                int64_t d = pcol::get_varint(p, blob_end);
+                v = row % block_rows == 0 ? d : v + d;
+                if (v >= key) return row;
+            }
+            return end;
+        }
+    };
+
+    // Table written from CsvLogger captures: one row per trade with the top of book at that time
+    inline std::vector<ColumnSpec> trade_table_columns() {
+        return {{"timestamp_recv", 0}, {"timestamp_exch", 0}, {"price", 8}, {"size", 8},
+                {"side", 0}, {"best_bid", 8}, {"best_ask", 8}};
+    }
+
+    // Table written from raw Polymarket frames: a SNAPSHOT row clears the book, LEVEL rows
+    // set the size at a price (bid side 1, ask side -1) and TRADE rows are last_trade_price prints
+    enum class BookRowKind {
+        SNAPSHOT = 0,
+        LEVEL = 1,
+        TRADE = 2
+    };
+
+    inline std::vector<ColumnSpec> book_table_columns() {
+        return {{"timestamp_recv", 0}, {"timestamp_exch", 0}, {"kind", 0}, {"side", 0},
+                {"price", 8}, {"size", 8}};
+    }
+
+    // <root>/<YYYY-MM-DD>/<VENUE>_<symbol>.<table>.pcol
+    inline std::string column_file_path(const std::string& root, int64_t day_ms, const std::string& venue,
+                                        const std::string& symbol, const std::string& table) {
+        return (std::filesystem::path(root) / utc_date(static_cast<uint64_t>(day_ms))
+            / (venue + "_" + symbol + "." + table + ".pcol")).string();
+    }
+}
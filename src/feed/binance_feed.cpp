@@ -1,4 +1,6 @@
 #include "feed /feed_client.h"
+#include "metrics/metrics.hpp"
+#include "feed /timestamped_stream.hpp"
 #include <boost/beast/core.hpp>
 #include <boost/beast/ssl.hpp>
 #include <boost/beast/websocket.hpp>
@@ -24,7 +26,7 @@ namespace poly {
         net::io_context& ioc_;
         ssl::context ctx_{ssl::context::tlsv12_client};
         tcp::resolver resolver_;
-        websocket::stream<beast::ssl_stream<beast::tcp_stream>> ws_;
+        websocket::stream<beast::ssl_stream<TimestampedStream>> ws_;
         beast::flat_buffer buffer_;
 
         std::string host_ = "stream.binance.com";
@@ -34,13 +36,36 @@ namespace poly {
 
         net::steady_timer reconnect_timer_;
         bool is_closing_ = false;
+        SocketProfile socket_profile_;
+        uint64_t frame_recv_ns_ = 0;
+        uint64_t frame_kernel_ns_ = 0;
 
         EventCallback callback_;
+
+        Counter frames_;
+        Counter bytes_;
+        Counter parse_errors_;
+        Counter reconnects_;
+        Counter downtime_ms_;
+        Gauge connected_;
+        LatencyHistogram callback_time_;
+        LatencyHistogram socket_delay_;
+        uint64_t disconnected_at_ = 0;
     public:
         BinanceFeed(net::io_context& ioc) : ioc_(ioc),
         resolver_(net::make_strand(ioc)),
         ws_(net::make_strand(ioc), ctx_),
-        reconnect_timer_(ioc) {
+        reconnect_timer_(ioc),
+        frames_("poly_feed_frames_total", "Websocket frames received", {{"feed", "binance"}}),
+        bytes_("poly_feed_bytes_total", "Websocket payload bytes received", {{"feed", "binance"}}),
+        parse_errors_("poly_feed_parse_errors_total", "Messages or fields that failed to parse", {{"feed", "binance"}}),
+        reconnects_("poly_feed_reconnects_total", "Connection failures that triggered a reconnect", {{"feed", "binance"}}),
+        downtime_ms_("poly_feed_downtime_seconds_total", "Time spent disconnected between a failure and the next handshake",
+            {{"feed", "binance"}}, 1e-3),
+        connected_("poly_feed_connected", "1 while the websocket is up", {{"feed", "binance"}}),
+        callback_time_("poly_feed_callback_seconds", "Time spent in the event callback", {{"feed", "binance"}}),
+        socket_delay_("poly_feed_socket_delay_seconds", "Kernel receive timestamp to the frame reaching the feed",
+            {{"feed", "binance"}}) {
             ws_.next_layer().set_verify_mode(ssl::verify_none);
 
             ws_.set_option(websocket::stream_base::timeout::suggested(beast::role_type::client));
@@ -63,6 +88,11 @@ namespace poly {
             callback_ = cb;
         }
 
+        // Applied on every (re)connect
+        void set_socket_profile(const SocketProfile& profile) {
+            socket_profile_ = profile;
+        }
+
         void subscribe(const std::string& token_id) override {
             active_token_id_ = token_id;
             if (ws_.is_open()) {
@@ -94,6 +124,7 @@ namespace poly {
             if (ec) return fail(ec, "connect");
 
             beast::get_lowest_layer(ws_).expires_never();
+            ws_.next_layer().next_layer().apply(socket_profile_);
             auto ssl_handle = ws_.next_layer().native_handle();
             if (!ssl_handle) {
                 return fail(beast::error_code(net::error::no_memory), "ssl_handle_null");
@@ -121,6 +152,11 @@ namespace poly {
             if (ec) return fail(ec, "handshake");
 
             spdlog::info("Connected via WSS");
+            connected_.set(1);
+            if (disconnected_at_ != 0) {
+                downtime_ms_.inc(now_ms() - disconnected_at_);
+                disconnected_at_ = 0;
+            }
 
             if (!active_token_id_.empty()) {
                 send_subscription();
@@ -137,6 +173,14 @@ namespace poly {
         void on_read(beast::error_code ec, std::size_t bytes_transferred) {
             if (ec) return fail(ec, "read");
 
+            frame_recv_ns_ = now_ns();
+            frame_kernel_ns_ = ws_.next_layer().next_layer().last_receive_ns();
+            if (frame_kernel_ns_ != 0 && frame_kernel_ns_ <= frame_recv_ns_) {
+                socket_delay_.observe_ns(frame_recv_ns_ - frame_kernel_ns_);
+            }
+            frames_.inc();
+            bytes_.inc(bytes_transferred);
+
             std::string data = beast::buffers_to_string(buffer_.data());
             buffer_.consume(buffer_.size());
 
@@ -168,6 +212,10 @@ namespace poly {
 
             spdlog::error("Network error: [{}]: {}", what, ec.message());
 
+            reconnects_.inc();
+            connected_.set(0);
+            if (disconnected_at_ == 0) disconnected_at_ = now_ms();
+
             spdlog::info("Reconnecting in 2 seconds...");
             beast::get_lowest_layer(ws_).close();
             reconnect_timer_.expires_after(std::chrono::seconds(2));
@@ -197,16 +245,23 @@ namespace poly {
                     evt.size = std::stod(s_str);
                     evt.timestamp_exch = item["T"];
                 } catch (...) {
+                    parse_errors_.inc();
                     spdlog::warn("Error converting numbers for event: {}", item.dump());
                     return;
                 }
 
                 evt.timestamp_recv = now_ms();
+                evt.timestamp_recv_ns = frame_recv_ns_;
+                evt.timestamp_kernel_ns = frame_kernel_ns_;
                 bool is_maker = item.value("m", false);
                 evt.side = is_maker ? Side::BUY : Side::SELL;
                 evt.original_payload = item.dump();
 
-                if (callback_) callback_(evt);
+                if (callback_) {
+                    auto start = std::chrono::steady_clock::now();
+                    callback_(evt);
+                    callback_time_.observe_since(start);
+                }
             }
         }
 
@@ -226,6 +281,7 @@ namespace poly {
                     }
                 }
             } catch (const std::exception& e) {
+                parse_errors_.inc();
                 spdlog::error("JSON Parse error: {} | Payload: {}", e.what(), raw_json);
             }
         }
@@ -1,5 +1,9 @@
 #include "feed /feed_client.h"
+#include "metrics/metrics.hpp"
+#include "feed /timestamped_stream.hpp"
+#include "feed /poly_messages.hpp"
 #include "core/orderbook.hpp"
+#include "core/shard_workers.hpp"
 #include <boost/beast/core.hpp>
 #include <boost/beast/ssl.hpp>
 #include <boost/beast/websocket.hpp>
@@ -8,6 +12,8 @@
 #include <nlohmann/json.hpp>
 #include <spdlog/spdlog.h>
 #include <iostream>
+#include <unordered_map>
+#include <variant>
 
 #include <openssl/ssl.h>
 #include <openssl/err.h>
@@ -22,10 +28,21 @@ using json = nlohmann::json;
 
 namespace poly {
     class PolyFeed : public std::enable_shared_from_this<PolyFeed>, public IFeedClient {
+        // A frame split into per-asset pieces; trades go through the same worker as the
+        // asset's book so they see it with every earlier update applied
+        using BookWork = std::variant<BookUpdate, MarketEvent>;
+
+        // Owned by one book worker, never touched from another thread
+        struct BookShard {
+            std::unordered_map<std::string, Orderbook> books;
+            std::unordered_map<std::string, std::pair<Gauge, Gauge>> level_gauges;
+        };
+
         net::io_context& ioc_;
+        net::strand<net::io_context::executor_type> strand_;
         ssl::context ctx_{ssl::context::tlsv12_client};
         tcp::resolver resolver_;
-        websocket::stream<beast::ssl_stream<beast::tcp_stream>> ws_;
+        websocket::stream<beast::ssl_stream<TimestampedStream>> ws_;
         beast::flat_buffer buffer_;
 
         std::string host_ = "ws-subscriptions-clob.polymarket.com";
@@ -35,15 +52,58 @@ namespace poly {
 
         net::steady_timer reconnect_timer_;
         bool is_closing_ = false;
+        SocketProfile socket_profile_;
+        uint64_t frame_recv_ns_ = 0;
+        uint64_t frame_kernel_ns_ = 0;
 
         EventCallback callback_;
-
-        std::unordered_map<std::string, Orderbook> books_;
+        BookCallback book_callback_;
+        RawCallback raw_callback_;
+
+        Counter frames_;
+        Counter bytes_;
+        Counter parse_errors_;
+        Counter reconnects_;
+        Counter downtime_ms_;
+        Gauge connected_;
+        LatencyHistogram callback_time_;
+        LatencyHistogram socket_delay_;
+        uint64_t disconnected_at_ = 0;
+
+        Counter queue_stalls_;
+        std::vector<Gauge> queue_depth_;
+        std::vector<BookShard> shards_;
+        // Last member: its threads are joined before anything they use is destroyed
+        ShardWorkers<BookWork> workers_;
     public:
-        PolyFeed(net::io_context& ioc) : ioc_(ioc),
+        // Books are maintained on book_workers threads, sharded by asset id; callbacks
+        // still run on the feed's strand
+        PolyFeed(net::io_context& ioc, std::size_t book_workers = 2) : ioc_(ioc),
+        strand_(net::make_strand(ioc)),
         resolver_(net::make_strand(ioc)),
-        ws_(net::make_strand(ioc), ctx_),
-        reconnect_timer_(ioc) {
+        ws_(strand_, ctx_),
+        reconnect_timer_(ioc),
+        frames_("poly_feed_frames_total", "Websocket frames received", {{"feed", "polymarket"}}),
+        bytes_("poly_feed_bytes_total", "Websocket payload bytes received", {{"feed", "polymarket"}}),
+        parse_errors_("poly_feed_parse_errors_total", "Messages or fields that failed to parse", {{"feed", "polymarket"}}),
+        reconnects_("poly_feed_reconnects_total", "Connection failures that triggered a reconnect", {{"feed", "polymarket"}}),
+        downtime_ms_("poly_feed_downtime_seconds_total", "Time spent disconnected between a failure and the next handshake",
+            {{"feed", "polymarket"}}, 1e-3),
+        connected_("poly_feed_connected", "1 while the websocket is up", {{"feed", "polymarket"}}),
+        callback_time_("poly_feed_callback_seconds", "Time spent in the event callback", {{"feed", "polymarket"}}),
+        socket_delay_("poly_feed_socket_delay_seconds", "Kernel receive timestamp to the frame reaching the feed",
+            {{"feed", "polymarket"}}),
+        queue_stalls_("poly_book_queue_stalls_total", "Pushes that waited for a full book worker queue"),
+        shards_(std::max<std::size_t>(book_workers, 1)),
+        workers_(shards_.size(),
+            [this](std::size_t shard, BookWork& work) { process_work(shard, work); }, 4096,
+            // The worker is the only writer, so the gauge falls back once a burst is applied
+            [this](std::size_t shard) { queue_depth_[shard].set(static_cast<double>(workers_.depth(shard))); }) {
+            for (std::size_t i = 0; i < shards_.size(); ++i) {
+                queue_depth_.emplace_back("poly_book_queue_depth", "Updates waiting for a book worker",
+                    MetricLabels{{"worker", std::to_string(i)}});
+            }
+
             ws_.next_layer().set_verify_mode(ssl::verify_none);
 
             ws_.set_option(websocket::stream_base::timeout::suggested(beast::role_type::client));
@@ -66,6 +126,19 @@ namespace poly {
             callback_ = cb;
         }
 
+        void set_book_callback(BookCallback cb) {
+            book_callback_ = cb;
+        }
+
+        void set_raw_callback(RawCallback cb) {
+            raw_callback_ = cb;
+        }
+
+        // Applied on every (re)connect
+        void set_socket_profile(const SocketProfile& profile) {
+            socket_profile_ = profile;
+        }
+
         void subscribe(const std::string& token_id) override {
             active_token_id_ = token_id;
             if (ws_.is_open()) {
@@ -97,6 +170,7 @@ namespace poly {
             if (ec) return fail(ec, "connect");
 
             beast::get_lowest_layer(ws_).expires_never();
+            ws_.next_layer().next_layer().apply(socket_profile_);
             auto ssl_handle = ws_.next_layer().native_handle();
             if (!ssl_handle) {
                 return fail(beast::error_code(net::error::no_memory), "ssl_handle_null");
@@ -124,6 +198,11 @@ namespace poly {
             if (ec) return fail(ec, "handshake");
 
             spdlog::info("Connected via WSS");
+            connected_.set(1);
+            if (disconnected_at_ != 0) {
+                downtime_ms_.inc(now_ms() - disconnected_at_);
+                disconnected_at_ = 0;
+            }
 
             if (!active_token_id_.empty()) {
                 send_subscription();
@@ -140,8 +219,17 @@ namespace poly {
         void on_read(beast::error_code ec, std::size_t bytes_transferred) {
             if (ec) return fail(ec, "read");
 
+            frame_recv_ns_ = now_ns();
+            frame_kernel_ns_ = ws_.next_layer().next_layer().last_receive_ns();
+            if (frame_kernel_ns_ != 0 && frame_kernel_ns_ <= frame_recv_ns_) {
+                socket_delay_.observe_ns(frame_recv_ns_ - frame_kernel_ns_);
+            }
+            frames_.inc();
+            bytes_.inc(bytes_transferred);
+
             std::string data = beast::buffers_to_string(buffer_.data());
             buffer_.consume(buffer_.size());
+            if (raw_callback_) raw_callback_(now_ms(), data);
 
             try {
                 parse_message(data);
@@ -171,6 +259,10 @@ namespace poly {
 
             spdlog::error("Network error: [{}]: {}", what, ec.message());
 
+            reconnects_.inc();
+            connected_.set(0);
+            if (disconnected_at_ == 0) disconnected_at_ = now_ms();
+
             spdlog::info("Reconnecting in 2 seconds...");
             beast::get_lowest_layer(ws_).close();
             reconnect_timer_.expires_after(std::chrono::seconds(2));
@@ -197,66 +289,104 @@ namespace poly {
             }
             if (type ==  "last_trade_price") {
                 MarketEvent evt;
-                evt.venue = Venue::POLYMARKET;
-                evt.symbol = item.value("asset_id", "unknown");
-                try {
-                    auto p_str = item.value("price", "0");
-                    evt.price = std::stod(p_str);
-
-                    auto s_str = item.value("size", "0");
-                    evt.size = std::stod(s_str);
-                    std::string ts_str = item.value("timestamp", "0");
-                    evt.timestamp_exch = std::stoull(ts_str);
-                } catch (...) {
+                if (!parse_trade(item, evt)) {
+                    parse_errors_.inc();
                     spdlog::warn("Error converting numbers for event: {}", item.dump());
                     return;
                 }
 
                 evt.timestamp_recv = now_ms();
-                evt.side = (item.value("side", "") == "BUY") ? Side::BUY : Side::SELL;
+                evt.timestamp_recv_ns = frame_recv_ns_;
+                evt.timestamp_kernel_ns = frame_kernel_ns_;
                 evt.original_payload = item.dump();
-
-                books_[evt.symbol].get_state(evt.best_bid, evt.best_ask, evt.bid_depth, evt.ask_depth);
-                if (callback_) callback_(evt);
+                dispatch(std::move(evt));
             }
         }
 
         void process_book(const json& item) {
-            try {
-                std::string asset = item["asset_id"];
-                if (item.contains("bids")) {
-                    for (const auto& level : item["bids"]) {
-                        double p = std::stod(level.value("price", "0"));
-                        double s = std::stod(level.value("size", "0"));
-                        books_[asset].update(true, p, s);
-                    }
-                }
-
-                if (item.contains("asks")) {
-                    for (const auto& level : item["asks"]) {
-                        double p = std::stod(level.value("price", "0"));
-                        double s = std::stod(level.value("size", "0"));
-                        books_[asset].update(false, p, s);
-                    }
-                }
-            } catch (...) {
+            BookUpdate upd;
+            if (!parse_book(item, upd)) {
+                parse_errors_.inc();
                 spdlog::warn("Book parse error");
+                return;
             }
+            dispatch(std::move(upd));
         }
 
         void process_price_change(const json& item) {
-            double price, size;
-            std::string asset;
-            try {
-                for (auto& chg : item["price_changes"]) {
-                    asset = chg["asset_id"];
-                    price = std::stod(chg.value("price", "0"));
-                    size = std::stod(chg.value("size", "0"));
-                    books_[asset].update(chg["side"] == "BUY", price, size);
-                }
-            } catch (...) {
+            std::vector<BookUpdate> updates;
+            if (!parse_price_change(item, updates)) {
+                parse_errors_.inc();
                 spdlog::warn("Book update parse error");
+                return;
+            }
+            for (auto& upd : updates) {
+                dispatch(std::move(upd));
+            }
+        }
+
+        void dispatch(BookUpdate upd) {
+            std::size_t shard = workers_.shard_of(upd.asset);
+            push_work(shard, std::move(upd));
+        }
+
+        void dispatch(MarketEvent evt) {
+            std::size_t shard = workers_.shard_of(evt.symbol);
+            push_work(shard, std::move(evt));
+        }
+
+        void push_work(std::size_t shard, BookWork work) {
+            if (!workers_.push(shard, std::move(work))) queue_stalls_.inc();
+        }
+
+        // Book worker threads from here on: only shards_[shard] is touched, results are
+        // posted back to the strand
+
+        void process_work(std::size_t shard, BookWork& work) {
+            BookShard& s = shards_[shard];
+            if (auto* upd = std::get_if<BookUpdate>(&work)) {
+                apply_update(s.books[upd->asset], *upd);
+                on_book_changed(s, upd->asset);
+                return;
+            }
+
+            auto& evt = std::get<MarketEvent>(work);
+            s.books[evt.symbol].get_state(evt.best_bid, evt.best_ask, evt.bid_depth, evt.ask_depth);
+            if (!callback_) return;
+            net::post(strand_, [self = weak_from_this(), evt = std::move(evt)]
+            {
+                auto feed = self.lock();
+                if (!feed || !feed->callback_) return;
+                auto start = std::chrono::steady_clock::now();
+                feed->callback_(evt);
+                feed->callback_time_.observe_since(start);
+            });
+        }
+
+        void on_book_changed(BookShard& s, const std::string& asset) {
+            Orderbook& book = s.books[asset];
+
+            auto gauges = s.level_gauges.find(asset);
+            if (gauges == s.level_gauges.end()) {
+                const char* help = "Price levels currently held in the book";
+                gauges = s.level_gauges.emplace(asset, std::make_pair(
+                    Gauge("poly_book_levels", help, {{"asset", asset}, {"side", "bid"}}),
+                    Gauge("poly_book_levels", help, {{"asset", asset}, {"side", "ask"}}))).first;
             }
+            size_t bid_levels, ask_levels;
+            book.get_levels(bid_levels, ask_levels);
+            gauges->second.first.set(static_cast<double>(bid_levels));
+            gauges->second.second.set(static_cast<double>(ask_levels));
+
+            if (!book_callback_) return;
+            BookTop top;
+            book.get_state(top.best_bid, top.best_ask, top.bid_depth, top.ask_depth);
+            top.timestamp_recv = now_ms();
+            net::post(strand_, [self = weak_from_this(), asset, top]
+            {
+                auto feed = self.lock();
+                if (feed && feed->book_callback_) feed->book_callback_(asset, top);
+            });
         }
 
         void parse_message(const std::string& raw_json) {
@@ -275,6 +405,7 @@ namespace poly {
                     }
                 }
             } catch (const std::exception& e) {
+                parse_errors_.inc();
                 spdlog::error("JSON Parse error: {} | Payload: {}", e.what(), raw_json);
             }
         }
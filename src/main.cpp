@@ -1,6 +1,11 @@
 #include "feed/poly_feed.cpp"
 #include "feed/binance_feed.cpp"
 #include "core/types.hpp"
+#include "core/trade_aggregator.hpp"
+#include "core/run_loop.hpp"
+#include "bus/market_bus.hpp"
+#include "metrics/metrics_server.hpp"
+#include <boost/asio/signal_set.hpp>
 #include <iostream>
 #include <fstream>
 #include <thread>
@@ -11,7 +16,8 @@ class CsvLogger {
 public:
     CsvLogger(const std::string& filename) {
         file_.open(filename);
-        file_ << "timestamp_recv,timestamp_exch,venue,symbol,price,size,side, best_bid, best_asks, spread, mid_price" << std::endl;
+        file_.precision(10);
+        file_ << "timestamp_recv,timestamp_exch,venue,symbol,price,size,side,best_bid,best_ask,spread,mid_price" << std::endl;
     }
     void log(const poly::MarketEvent& evt) {
         std::lock_guard<std::mutex> lock(mtx_);
@@ -35,28 +41,135 @@ public:
     }
 };
 
-int main() {
-    boost::asio::io_context ioc;
+// Raw Polymarket frames, one per line as "<timestamp_recv>\t<json>", for book replay.
+// Rotated per UTC day into <prefix>-YYYY-MM-DD.log, the granularity of the column store
+class FrameLogger {
+    std::string prefix_;
+    std::ofstream file_;
+    uint64_t day_ = 0;
+    std::mutex mtx_;
+public:
+    FrameLogger(const std::string& prefix) : prefix_(prefix) {}
+
+    void log(uint64_t timestamp_recv, const std::string& frame) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        uint64_t day = timestamp_recv / 86400000;
+        if (!file_.is_open() || day != day_) {
+            if (file_.is_open()) file_.close();
+            day_ = day;
+            std::string filename = prefix_ + "-" + poly::utc_date(timestamp_recv) + ".log";
+            file_.open(filename, std::ios::app);
+            if (!file_) std::cerr << "Cannot open " << filename << std::endl;
+        }
+        file_ << timestamp_recv << "\t" << frame << "\n";
+    }
+
+    ~FrameLogger() {
+        if (file_.is_open()) file_.flush();
+    }
+};
+
+// Wakes shortly after each minute boundary and prints the minute that just closed; the
+// grace period lets trades stamped before the boundary arrive first
+void report_bars(boost::asio::steady_timer& timer, const poly::TradeAggregator& aggregator) {
+    constexpr uint64_t kGraceMs = 500;
+    uint64_t now = poly::now_ms();
+    timer.expires_after(std::chrono::milliseconds(60000 - now % 60000 + kGraceMs));
+    timer.async_wait([&timer, &aggregator](boost::system::error_code ec)
+    {
+        if (ec) return;
+        uint64_t closed = (poly::now_ms() - kGraceMs) / 60000 * 60000 - 60000;
+        for (auto venue : {poly::Venue::POLYMARKET, poly::Venue::BINANCE}) {
+            // The newest bar is the minute in progress, the one before it is complete
+            auto bars = aggregator.last(venue, poly::BarPeriod::MINUTE, 2);
+            auto bar = std::find_if(bars.begin(), bars.end(), [closed](const poly::Bar& b) { return b.start_ms == closed; });
+            if (bar == bars.end()) continue;
+            std::cout << "[BAR 1m] " << (venue == poly::Venue::POLYMARKET ? "POLY" : "BINANCE")
+                << " " << bar->start_ms << " O " << bar->open << " H " << bar->high << " L " << bar->low
+                << " C " << bar->close << " V " << bar->volume << " VWAP " << bar->vwap()
+                << " N " << bar->trades << std::endl;
+        }
+        report_bars(timer, aggregator);
+    });
+}
+
+// Flags: --low-latency applies SocketProfile::low_latency() to the feed sockets,
+// --busy-poll <cpu> spins the I/O thread on that core instead of blocking in run(),
+// --book-workers <n> sets the number of Polymarket book maintenance threads
+int main(int argc, char** argv) {
+    poly::SocketProfile socket_profile;
+    poly::RunLoopConfig run_loop;
+    std::size_t book_workers = 2;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--low-latency") {
+            socket_profile = poly::SocketProfile::low_latency();
+        } else if (arg == "--busy-poll" && i + 1 < argc) {
+            run_loop.busy_poll = true;
+            run_loop.cpu = std::atoi(argv[++i]);
+        } else if (arg == "--book-workers" && i + 1 < argc) {
+            book_workers = std::max(1, std::atoi(argv[++i]));
+        } else {
+            std::cerr << "usage: " << argv[0] << " [--low-latency] [--busy-poll <cpu>] [--book-workers <n>]" << std::endl;
+            return 1;
+        }
+    }
+
+    boost::asio::io_context ioc(1);
     CsvLogger logger("market_data.log");
-    auto poly_feed = std::make_shared<poly::PolyFeed>(ioc);
-    poly_feed->set_calback([&logger](const poly::MarketEvent& evt)
+    FrameLogger frames("poly_frames");
+    poly::MarketBusWriter bus("/poly_market_bus");
+    if (!bus.open()) {
+        std::cerr << "Market bus unavailable, local strategies will not receive data" << std::endl;
+    }
+    poly::TradeAggregator aggregator;
+
+    auto poly_feed = std::make_shared<poly::PolyFeed>(ioc, book_workers);
+    poly_feed->set_socket_profile(socket_profile);
+    poly_feed->set_calback([&logger, &bus, &aggregator](const poly::MarketEvent& evt)
     {
         logger.log(evt);
+        bus.publish(evt);
+        aggregator.on_event(evt);
         std::cout << "[TRADE]" << evt.price << " (" << evt.size << ")" << std::endl;
     });
+    poly_feed->set_raw_callback([&frames](uint64_t timestamp_recv, const std::string& frame)
+    {
+        frames.log(timestamp_recv, frame);
+    });
+    poly_feed->set_book_callback([&bus](const std::string& asset, const poly::BookTop& top)
+    {
+        bus.publish_book(asset, top);
+    });
     auto binance_feed = std::make_shared<poly::BinanceFeed>(ioc);
-    binance_feed->set_calback([&logger](const poly::MarketEvent& evt)
+    binance_feed->set_socket_profile(socket_profile);
+    binance_feed->set_calback([&logger, &bus, &aggregator](const poly::MarketEvent& evt)
     {
         logger.log(evt);
+        bus.publish(evt);
+        aggregator.on_event(evt);
         std::cout << "[TRADE]" << evt.price << " (" << evt.size << ")" << std::endl;
     });
 
+    // Stop on SIGINT/SIGTERM so the destructors run: the bus marks itself closed for its readers
+    boost::asio::signal_set signals(ioc, SIGINT, SIGTERM);
+    signals.async_wait([&ioc](const boost::system::error_code& ec, int signal)
+    {
+        if (ec) return;
+        std::cerr << "Signal " << signal << ", shutting down" << std::endl;
+        ioc.stop();
+    });
+
+    std::make_shared<poly::MetricsServer>(ioc, 9464)->run();
+    boost::asio::steady_timer bar_timer(ioc);
+    report_bars(bar_timer, aggregator);
+
     try {
         poly_feed->connect();
         std::string active_asset_id = "27801427116870763425813473135293780501482981171413880573576379343739069284230";
         poly_feed->subscribe(active_asset_id);
         binance_feed->connect();
-        ioc.run();
+        poly::run_io(ioc, run_loop);
     } catch (const std::exception& e) {
         std::cerr << "Fata error" << e.what() << std::endl;
     }
@@ -0,0 +1,191 @@
+#include "store/column_store.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+// ColumnWriter / ColumnReader round trips, time seeks and rejection of damaged files.
+// Returns non-zero on the first failed check.
+
+namespace {
+    int failures = 0;
+
+    void check(bool ok, const std::string& what) {
+        if (ok) return;
+        std::fprintf(stderr, "FAILED: %s\n", what.c_str());
+        ++failures;
+    }
+
+    std::string temp_path(const std::string& name) {
+        return (std::filesystem::temp_directory_path() / ("column_store_test_" + name + ".pcol")).string();
+    }
+
+    std::vector<poly::ColumnSpec> specs() {
+        return {{"ts", 0}, {"price", 4}, {"size", 2}};
+    }
+
+    // Keys repeat in runs of 7 so duplicates straddle block boundaries for most block sizes.
+    // Values are built as integer / 10^decimals, the doubles the reader hands back.
+    std::vector<std::vector<double>> make_rows(std::size_t n) {
+        std::vector<std::vector<double>> rows;
+        for (std::size_t i = 0; i < n; ++i) {
+            double ts = 1700000000000.0 + static_cast<double>(i / 7) * 3;
+            double price = static_cast<double>((static_cast<int64_t>(i % 113) - 56) * 125) / 10000.0;
+            double size = static_cast<double>((i * 37) % 1000) / 100.0;
+            rows.push_back({ts, price, size});
+        }
+        return rows;
+    }
+
+    bool write_file(const std::string& path, const std::vector<std::vector<double>>& rows, uint32_t block_rows) {
+        poly::ColumnWriter writer(specs(), block_rows);
+        for (const auto& row : rows) {
+            if (!writer.append(row)) return false;
+        }
+        return writer.write(path);
+    }
+
+    void round_trip() {
+        const auto rows = make_rows(1000);
+        for (uint32_t block_rows : {1u, 3u, 64u, 1000u, 4096u}) {
+            std::string tag = "block_rows " + std::to_string(block_rows);
+            std::string path = temp_path("round_trip");
+            check(write_file(path, rows, block_rows), tag + ": write");
+
+            poly::ColumnReader reader;
+            check(reader.open(path), tag + ": open");
+            if (!reader.is_open()) continue;
+            check(reader.rows() == rows.size(), tag + ": row count");
+            check(reader.column_count() == 3 && reader.column_name(1) == "price", tag + ": column table");
+
+            bool same = true;
+            for (std::size_t c = 0; c < 3; ++c) {
+                auto values = reader.read_values(c, reader.all());
+                for (std::size_t i = 0; i < rows.size(); ++i) same = same && values[i] == rows[i][c];
+            }
+            check(same, tag + ": every value reads back");
+
+            // Ranges that start and end inside blocks
+            for (std::size_t begin : {0, 1, 63, 64, 500, 999}) {
+                for (std::size_t end : {begin, begin + 1, begin + 130, std::size_t{1000}}) {
+                    end = std::min<std::size_t>(end, rows.size());
+                    auto values = reader.read_values(1, {begin, end});
+                    bool ok = values.size() == end - begin;
+                    for (std::size_t i = begin; ok && i < end; ++i) ok = values[i - begin] == rows[i][1];
+                    check(ok, tag + ": partial range " + std::to_string(begin) + ".." + std::to_string(end));
+                }
+            }
+            std::filesystem::remove(path);
+        }
+    }
+
+    // find_range must agree with std::lower_bound over the decoded keys
+    void find_range_matches_brute_force() {
+        const auto rows = make_rows(500);
+        std::vector<int64_t> keys;
+        for (const auto& row : rows) keys.push_back(static_cast<int64_t>(row[0]));
+
+        for (uint32_t block_rows : {1u, 5u, 7u, 64u}) {
+            std::string tag = "block_rows " + std::to_string(block_rows);
+            std::string path = temp_path("find_range");
+            write_file(path, rows, block_rows);
+            poly::ColumnReader reader;
+            check(reader.open(path), tag + ": open");
+            if (!reader.is_open()) continue;
+
+            auto row_of = [&](int64_t key) {
+                return static_cast<std::size_t>(std::lower_bound(keys.begin(), keys.end(), key) - keys.begin());
+            };
+            bool ok = true;
+            for (int64_t from = keys.front() - 2; ok && from <= keys.back() + 2; ++from) {
+                for (int64_t to : {from, from + 1, from + 3, from + 20, keys.back() + 1}) {
+                    poly::RowRange range = reader.find_range(from, to);
+                    poly::RowRange expected = from >= to ? poly::RowRange{} : poly::RowRange{row_of(from), row_of(to)};
+                    if (range.begin != expected.begin || range.end != expected.end) {
+                        check(false, tag + ": find_range(" + std::to_string(from) + ", " + std::to_string(to) + ")");
+                        ok = false;
+                        break;
+                    }
+                }
+            }
+            std::filesystem::remove(path);
+        }
+    }
+
+    void empty_file() {
+        std::string path = temp_path("empty");
+        check(write_file(path, {}, 16), "empty: write");
+        poly::ColumnReader reader;
+        check(reader.open(path), "empty: open");
+        check(reader.rows() == 0, "empty: no rows");
+        check(reader.find_range(0, 1000).size() == 0, "empty: find_range");
+        check(reader.read_raw(0, reader.all()).empty(), "empty: read_raw");
+        std::filesystem::remove(path);
+    }
+
+    std::vector<char> load(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    }
+
+    bool opens(const std::string& path, const std::vector<char>& bytes) {
+        std::ofstream(path, std::ios::binary | std::ios::trunc).write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        poly::ColumnReader reader;
+        return reader.open(path);
+    }
+
+    void damaged_files_are_rejected() {
+        std::string path = temp_path("damaged");
+        write_file(path, make_rows(300), 16);
+        const auto good = load(path);
+        check(opens(path, good), "damaged: intact copy opens");
+
+        poly::pcol::FileHeader header;
+        std::memcpy(&header, good.data(), sizeof(header));
+
+        auto truncated = good;
+        truncated.resize(truncated.size() - sizeof(uint64_t));
+        check(!opens(path, truncated), "damaged: truncated index");
+
+        // Last block offset of the last column points past its data
+        auto bad_offset = good;
+        uint64_t huge = ~uint64_t{0} >> 1;
+        std::memcpy(bad_offset.data() + bad_offset.size() - sizeof(uint64_t), &huge, sizeof(huge));
+        check(!opens(path, bad_offset), "damaged: block offset past column data");
+
+        auto misaligned = good;
+        poly::pcol::FileHeader h = header;
+        h.index_offset += 4;
+        std::memcpy(misaligned.data(), &h, sizeof(h));
+        check(!opens(path, misaligned), "damaged: misaligned index offset");
+
+        auto wrong_blocks = good;
+        h = header;
+        h.block_count += 1;
+        std::memcpy(wrong_blocks.data(), &h, sizeof(h));
+        check(!opens(path, wrong_blocks), "damaged: block count disagrees with row count");
+
+        auto column_overrun = good;
+        poly::pcol::ColumnDesc desc;
+        std::memcpy(&desc, good.data() + sizeof(header), sizeof(desc));
+        desc.length = good.size();
+        std::memcpy(column_overrun.data() + sizeof(header), &desc, sizeof(desc));
+        check(!opens(path, column_overrun), "damaged: column length past end of file");
+
+        std::filesystem::remove(path);
+    }
+}
+
+int main() {
+    round_trip();
+    find_range_matches_brute_force();
+    empty_file();
+    damaged_files_are_rejected();
+    if (failures == 0) std::printf("column_store_test: ok\n");
+    return failures == 0 ? 0 : 1;
+}
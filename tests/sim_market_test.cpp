@@ -0,0 +1,123 @@
+#include "backtest/sim_market.hpp"
+#include <cmath>
+#include <cstdio>
+
+// Queue-position model of SimMarket. Returns non-zero on the first failed check.
+
+namespace {
+    int failures = 0;
+
+    void check(bool ok, const char* what) {
+        if (ok) return;
+        std::fprintf(stderr, "FAILED: %s\n", what);
+        ++failures;
+    }
+
+    bool near(double a, double b) { return std::abs(a - b) < 1e-9; }
+
+    // Replays a level row the way the backtester does
+    void level(poly::Orderbook& book, poly::SimMarket& market, bool is_bid, double price, double size) {
+        double old_size = book.size_at(is_bid, price);
+        book.update(is_bid, price, size);
+        market.on_level(is_bid, price, old_size, size);
+    }
+
+    // A print followed by the level decrease it caused must only move the queue once
+    void trade_then_level() {
+        poly::Orderbook book;
+        book.update(true, 0.50, 100);
+        book.update(false, 0.52, 100);
+        poly::SimMarket market(book);
+        market.place_limit(poly::Side::BUY, 0.50, 10);
+        check(near(market.orders()[0].queue_ahead, 100), "joins behind the displayed size");
+
+        market.set_exchange_time(1);
+        market.on_trade(0.50, 60, poly::Side::SELL);
+        check(near(market.orders()[0].queue_ahead, 40), "print eats the queue ahead");
+        level(book, market, true, 0.50, 40);
+        market.set_exchange_time(2);
+        check(near(market.orders()[0].queue_ahead, 40), "level drop explained by the print is not a cancel");
+        check(market.fill_count() == 0, "no fill while queue remains");
+
+        // A later drop with no print behind it is a cancel spread over the queue
+        level(book, market, true, 0.50, 20);
+        market.set_exchange_time(3);
+        check(near(market.orders()[0].queue_ahead, 20), "proportional cancel");
+    }
+
+    // Same as above with the level decrease arriving before its print
+    void level_then_trade() {
+        poly::Orderbook book;
+        book.update(true, 0.50, 100);
+        book.update(false, 0.52, 100);
+        poly::SimMarket market(book);
+        market.place_limit(poly::Side::BUY, 0.50, 10);
+
+        market.set_exchange_time(1);
+        level(book, market, true, 0.50, 40);
+        market.on_trade(0.50, 60, poly::Side::SELL);
+        check(near(market.orders()[0].queue_ahead, 40), "decrease then print moves the queue once");
+        market.set_exchange_time(2);
+        check(near(market.orders()[0].queue_ahead, 40), "matched decrease is not settled as a cancel");
+        check(market.fill_count() == 0, "no fill while queue remains");
+    }
+
+    // A print no decrease showed in its group must not explain a later cancel
+    void unmatched_print_expires() {
+        poly::Orderbook book;
+        book.update(true, 0.50, 100);
+        poly::SimMarket market(book);
+        market.place_limit(poly::Side::BUY, 0.50, 10);
+
+        market.set_exchange_time(1);
+        market.on_trade(0.50, 50, poly::Side::SELL);
+        check(near(market.orders()[0].queue_ahead, 50), "print eats the queue ahead");
+
+        market.set_exchange_time(2);
+        level(book, market, true, 0.50, 50);
+        market.set_exchange_time(3);
+        check(near(market.orders()[0].queue_ahead, 25), "later drop is a cancel, not the old print");
+    }
+
+    // Part of a decrease is the print, the rest is cancels
+    void trade_and_cancel_in_one_row() {
+        poly::Orderbook book;
+        book.update(true, 0.50, 100);
+        poly::SimMarket market(book);
+        market.place_limit(poly::Side::BUY, 0.50, 10);
+
+        market.set_exchange_time(1);
+        market.on_trade(0.50, 50, poly::Side::SELL);
+        level(book, market, true, 0.50, 25);
+        market.set_exchange_time(2);
+        // 50 left ahead of 50 resting after the print, 25 cancelled evenly -> 25 ahead
+        check(near(market.orders()[0].queue_ahead, 25), "residual decrease treated as cancel");
+    }
+
+    // A buyer lifting the ask must not touch resting bids at the same price
+    void print_only_hits_its_side() {
+        poly::Orderbook book;
+        book.update(true, 0.50, 100);
+        book.update(false, 0.51, 100);
+        poly::SimMarket market(book);
+        market.place_limit(poly::Side::BUY, 0.50, 10);
+
+        market.on_trade(0.50, 200, poly::Side::BUY);
+        check(near(market.orders()[0].queue_ahead, 100), "buy print leaves the bid queue alone");
+        check(market.fill_count() == 0, "buy print does not fill a bid");
+
+        market.on_trade(0.50, 130, poly::Side::SELL);
+        check(market.fill_count() == 1, "sell print past the queue fills the bid");
+        check(near(market.position(), 10), "filled the full order");
+    }
+}
+
+int main() {
+    trade_then_level();
+    level_then_trade();
+    unmatched_print_expires();
+    trade_and_cancel_in_one_row();
+    print_only_hits_its_side();
+    if (failures == 0) std::printf("sim_market_test: ok\n");
+    return failures == 0 ? 0 : 1;
+}
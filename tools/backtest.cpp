@@ -0,0 +1,157 @@
+#include "backtest/backtester.hpp"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+// Parameter sweep of a passive quoting strategy over compacted Polymarket books.
+//
+//   backtest <store_dir> [--threads N] [--fee F] [--param name=start:stop:step ...]
+//
+// Parameters: offset (ticks below the best bid to join), target (ticks of profit to ask
+// for once filled), size. Results go to stdout as CSV, best PnL first.
+
+namespace {
+    constexpr double kTick = 0.01;
+
+    class QuoteStrategy : public poly::IStrategy {
+        double offset_;
+        double target_;
+        double size_;
+
+        uint64_t bid_id_ = 0;
+        double bid_price_ = 0.0;
+        uint64_t ask_id_ = 0;
+        double entry_ = 0.0;
+    public:
+        explicit QuoteStrategy(const std::vector<double>& p) : offset_(p[0]), target_(p[1]), size_(p[2]) {}
+
+        void on_window_start(poly::SimContext&) override {
+            bid_id_ = ask_id_ = 0;
+        }
+
+        void on_book(poly::SimContext& ctx) override {
+            auto top = ctx.top();
+            if (top.best_bid <= 0.0 || top.best_ask >= 1.0) return;
+
+            if (ctx.market.position() > poly::SimMarket::kEps) {
+                if (!ask_id_) {
+                    double price = std::min(0.99, std::round((entry_ + target_ * kTick) / kTick) * kTick);
+                    ask_id_ = ctx.market.place_limit(poly::Side::SELL, price, ctx.market.position());
+                }
+                return;
+            }
+
+            double price = std::round((top.best_bid - offset_ * kTick) / kTick) * kTick;
+            if (price < kTick) return;
+            if (bid_id_ && std::abs(price - bid_price_) < kTick / 2) return;
+
+            if (bid_id_) ctx.market.cancel(bid_id_);
+            bid_price_ = price;
+            bid_id_ = ctx.market.place_limit(poly::Side::BUY, price, size_);
+        }
+
+        void on_fill(poly::SimContext& ctx, const poly::SimFill& fill) override {
+            if (fill.side == poly::Side::BUY) {
+                entry_ = fill.price;
+                ctx.market.cancel(fill.order_id);
+                bid_id_ = 0;
+                if (ask_id_) ctx.market.cancel(ask_id_);
+                ask_id_ = 0;
+            } else if (ctx.market.position() <= poly::SimMarket::kEps) {
+                ask_id_ = 0;
+            }
+        }
+    };
+
+    bool parse_axis(const std::string& spec, std::string& name, std::vector<double>& axis) {
+        auto eq = spec.find('=');
+        auto c1 = spec.find(':', eq);
+        auto c2 = c1 == std::string::npos ? std::string::npos : spec.find(':', c1 + 1);
+        if (eq == std::string::npos || c2 == std::string::npos) return false;
+
+        name = spec.substr(0, eq);
+        double start = std::stod(spec.substr(eq + 1, c1 - eq - 1));
+        double stop = std::stod(spec.substr(c1 + 1, c2 - c1 - 1));
+        double step = std::stod(spec.substr(c2 + 1));
+        if (step <= 0.0 || stop < start) return false;
+
+        axis.clear();
+        for (double v = start; v <= stop + step * 1e-6; v += step) axis.push_back(v);
+        return true;
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "usage: " << argv[0]
+            << " <store_dir> [--threads N] [--fee F] [--param name=start:stop:step ...]" << std::endl;
+        return 1;
+    }
+
+    poly::BacktestConfig cfg;
+    std::map<std::string, std::vector<double>> axes = {
+        {"offset", {0, 1, 2, 3}},
+        {"target", {1, 2, 3, 5}},
+        {"size", {10, 50}}
+    };
+
+    try {
+        for (int i = 2; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--threads" && i + 1 < argc) {
+                cfg.threads = std::stoul(argv[++i]);
+            } else if (arg == "--fee" && i + 1 < argc) {
+                cfg.taker_fee = std::stod(argv[++i]);
+            } else if (arg == "--param" && i + 1 < argc) {
+                std::string name;
+                std::vector<double> axis;
+                if (!parse_axis(argv[++i], name, axis) || !axes.count(name)) {
+                    spdlog::error("Bad --param {}", argv[i]);
+                    return 1;
+                }
+                axes[name] = axis;
+            } else {
+                spdlog::error("Unknown argument {}", arg);
+                return 1;
+            }
+        }
+    } catch (const std::exception& e) {
+        spdlog::error("Bad arguments: {}", e.what());
+        return 1;
+    }
+
+    poly::ParamGrid grid;
+    for (const char* name : {"offset", "target", "size"}) grid.add(name, axes[name]);
+
+    auto files = poly::Backtester::find_files(argv[1]);
+    if (files.empty()) {
+        spdlog::error("No *.book.pcol files under {}", argv[1]);
+        return 1;
+    }
+    spdlog::info("{} files x {} parameter sets on {} threads", files.size(), grid.size(), cfg.threads);
+
+    auto start = std::chrono::steady_clock::now();
+    poly::Backtester backtester(cfg);
+    auto results = backtester.run(files, grid, [](const std::vector<double>& params) {
+        return std::make_unique<QuoteStrategy>(params);
+    });
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    spdlog::info("Done in {:.2f}s", elapsed);
+
+    std::sort(results.begin(), results.end(),
+        [](const auto& a, const auto& b) { return a.pnl > b.pnl; });
+
+    for (const auto& name : grid.names) std::cout << name << ",";
+    std::cout << "pnl,worst_window,windows,fills,volume" << std::endl;
+    for (const auto& r : results) {
+        for (double p : r.params) std::cout << p << ",";
+        std::cout << r.pnl << "," << r.worst_window << "," << r.windows << ","
+            << r.fills << "," << r.volume << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,40 @@
+#include "bus/bus_client.hpp"
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+// Minimal market bus consumer: prints the late-join snapshot, then follows the event stream.
+int main(int argc, char** argv) {
+    std::string name = argc > 1 ? argv[1] : "/poly_market_bus";
+    poly::MarketBusReader reader(name);
+
+    for (;;) {
+        while (!reader.attach()) {
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+        }
+
+        for (const auto& [asset, top] : reader.snapshot()) {
+            std::cout << "[BOOK] " << asset << " " << top.best_bid << " / " << top.best_ask << std::endl;
+        }
+
+        poly::BusEvent evt;
+        uint64_t reported_lost = 0;
+        while (reader.writer_alive()) {
+            switch (reader.next(evt)) {
+                case poly::MarketBusReader::ReadStatus::OK:
+                    std::cout << "[TRADE] " << evt.symbol << " " << evt.price << " (" << evt.size << ")"
+                        << " bid " << evt.best_bid << " ask " << evt.best_ask << std::endl;
+                    break;
+                case poly::MarketBusReader::ReadStatus::OVERRUN:
+                    std::cerr << "Overrun: " << reader.lost() - reported_lost << " events lost" << std::endl;
+                    reported_lost = reader.lost();
+                    break;
+                case poly::MarketBusReader::ReadStatus::EMPTY:
+                    std::this_thread::yield();
+                    break;
+            }
+        }
+
+        std::cerr << "Writer went away, re-attaching" << std::endl;
+    }
+}
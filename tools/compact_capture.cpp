@@ -0,0 +1,205 @@
+#include "store/column_store.hpp"
+#include "feed /poly_messages.hpp"
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// Converts captures into per-day, per-instrument column files.
+//
+//   compact_capture <market_data.log>... <store_dir>            CsvLogger trades   -> *.trades.pcol
+//   compact_capture --book <poly_frames-*.log>... <store_dir>   FrameLogger frames -> *.book.pcol
+//
+// Captures are read in name order and only one UTC day is held in memory: a day's files
+// are written as soon as a line from a later day shows up. Lines that arrive after their
+// day was written are counted and dropped.
+
+namespace {
+    using Key = std::tuple<int64_t, std::string, std::string>;  // day start ms, venue, symbol
+
+    int64_t day_of(double timestamp_ms) {
+        return static_cast<int64_t>(timestamp_ms) / 86400000 * 86400000;
+    }
+
+    // Rows of the current day, row-major with one flat vector per instrument
+    class Compactor {
+        std::string root_;
+        std::string table_;
+        std::vector<poly::ColumnSpec> specs_;
+        std::map<Key, std::vector<double>> tables_;
+        int64_t day_ = std::numeric_limits<int64_t>::min();
+    public:
+        std::size_t files = 0;
+        std::size_t late = 0;
+        bool ok = true;
+
+        Compactor(std::string root, std::string table, std::vector<poly::ColumnSpec> specs)
+            : root_(std::move(root)), table_(std::move(table)), specs_(std::move(specs)) {}
+
+        // Appends one row; the day of the row decides whether earlier days get written first
+        void add(double ts_recv, const std::string& venue, const std::string& symbol,
+                 std::initializer_list<double> row) {
+            int64_t day = day_of(ts_recv);
+            if (day > day_) {
+                flush();
+                day_ = day;
+            } else if (day < day_) {
+                ++late;
+                return;
+            }
+            auto& values = tables_[{day, venue, symbol}];
+            values.insert(values.end(), row);
+        }
+
+        void flush() {
+            const std::size_t width = specs_.size();
+            for (auto& [key, values] : tables_) {
+                const auto& [day, venue, symbol] = key;
+                std::size_t rows = values.size() / width;
+
+                // Stable: rows from one frame share a timestamp and must keep their order
+                std::vector<uint32_t> order(rows);
+                std::iota(order.begin(), order.end(), 0);
+                std::stable_sort(order.begin(), order.end(),
+                    [&](uint32_t a, uint32_t b) { return values[a * width] < values[b * width]; });
+
+                poly::ColumnWriter writer(specs_);
+                for (uint32_t r : order) writer.append(&values[r * width]);
+
+                std::string path = poly::column_file_path(root_, day, venue, symbol, table_);
+                std::filesystem::create_directories(std::filesystem::path(path).parent_path());
+                if (!writer.write(path)) {
+                    ok = false;
+                    continue;
+                }
+                ++files;
+                spdlog::info("{}: {} rows", path, writer.rows());
+            }
+            tables_.clear();
+        }
+    };
+
+    std::vector<std::string> split(const std::string& line) {
+        std::vector<std::string> fields;
+        std::stringstream ss(line);
+        std::string field;
+        while (std::getline(ss, field, ',')) {
+            auto first = field.find_first_not_of(" \t\r");
+            auto last = field.find_last_not_of(" \t\r");
+            fields.push_back(first == std::string::npos ? "" : field.substr(first, last - first + 1));
+        }
+        return fields;
+    }
+
+    // Fields: timestamp_recv, timestamp_exch, venue, symbol, price, size, side, best_bid, best_ask, spread, mid
+    bool read_trade_line(const std::string& line, Compactor& out) {
+        auto f = split(line);
+        if (f.size() < 9) return false;
+        double ts_recv = std::stod(f[0]);
+        out.add(ts_recv, f[2], f[3], {
+            ts_recv, std::stod(f[1]), std::stod(f[4]), std::stod(f[5]),
+            f[6] == "BUY" ? 1.0 : -1.0, std::stod(f[7]), std::stod(f[8])
+        });
+        return true;
+    }
+
+    void add_book_rows(double ts_recv, const poly::BookUpdate& upd, Compactor& out) {
+        double ts_exch = static_cast<double>(upd.timestamp_exch);
+        if (upd.snapshot) {
+            out.add(ts_recv, "POLY", upd.asset,
+                {ts_recv, ts_exch, static_cast<double>(poly::BookRowKind::SNAPSHOT), 0.0, 0.0, 0.0});
+        }
+        for (const auto& level : upd.levels) {
+            out.add(ts_recv, "POLY", upd.asset, {ts_recv, ts_exch, static_cast<double>(poly::BookRowKind::LEVEL),
+                                                 level.is_bid ? 1.0 : -1.0, level.price, level.size});
+        }
+    }
+
+    // "<timestamp_recv>\t<frame json>"
+    bool read_frame_line(const std::string& line, Compactor& out) {
+        auto tab = line.find('\t');
+        if (tab == std::string::npos) return false;
+        double ts_recv = std::stod(line.substr(0, tab));
+
+        auto j = nlohmann::json::parse(line.begin() + static_cast<std::ptrdiff_t>(tab) + 1, line.end());
+        std::vector<nlohmann::json> items;
+        if (j.is_array()) items.assign(j.begin(), j.end());
+        else if (j.is_object()) items.push_back(std::move(j));
+
+        for (const auto& item : items) {
+            std::string type = item.value("event_type", "");
+            if (type == "book") {
+                poly::BookUpdate upd;
+                if (!poly::parse_book(item, upd)) return false;
+                add_book_rows(ts_recv, upd, out);
+            } else if (type == "price_change") {
+                std::vector<poly::BookUpdate> updates;
+                if (!poly::parse_price_change(item, updates)) return false;
+                for (const auto& upd : updates) add_book_rows(ts_recv, upd, out);
+            } else if (type == "last_trade_price") {
+                poly::MarketEvent evt;
+                if (!poly::parse_trade(item, evt)) return false;
+                out.add(ts_recv, "POLY", evt.symbol, {
+                    ts_recv, static_cast<double>(evt.timestamp_exch), static_cast<double>(poly::BookRowKind::TRADE),
+                    evt.side == poly::Side::BUY ? 1.0 : -1.0, evt.price, evt.size
+                });
+            }
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv) {
+    bool book = argc > 1 && std::string(argv[1]) == "--book";
+    int first = book ? 2 : 1;
+    if (argc < first + 2) {
+        std::cerr << "usage: " << argv[0] << " [--book] <capture>... <store_dir>" << std::endl;
+        return 1;
+    }
+    std::vector<std::string> inputs(argv + first, argv + argc - 1);
+    std::sort(inputs.begin(), inputs.end());
+
+    Compactor out(argv[argc - 1], book ? "book" : "trades",
+        book ? poly::book_table_columns() : poly::trade_table_columns());
+
+    std::size_t parsed = 0, skipped = 0;
+    for (const auto& input : inputs) {
+        std::ifstream in(input);
+        if (!in) {
+            spdlog::error("Cannot open {}", input);
+            return 1;
+        }
+
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.empty()) continue;
+            // Header lines (there may be several when captures were appended) start with a name
+            if (!std::isdigit(static_cast<unsigned char>(line[0]))) continue;
+
+            bool ok = false;
+            try {
+                ok = book ? read_frame_line(line, out) : read_trade_line(line, out);
+            } catch (...) {
+                ok = false;
+            }
+            if (ok) ++parsed;
+            else ++skipped;
+        }
+    }
+    out.flush();
+    if (!out.ok) return 1;
+
+    if (out.late > 0) spdlog::warn("{} rows dropped: their day had already been written", out.late);
+    spdlog::info("Compacted {} lines into {} files ({} malformed lines skipped)", parsed, out.files, skipped);
+    return 0;
+}
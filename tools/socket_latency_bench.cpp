@@ -0,0 +1,201 @@
+#include "feed /timestamped_stream.hpp"
+#include "core/run_loop.hpp"
+#include "core/types.hpp"
+#include <boost/asio/connect.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Loopback wake-up latency of the feed read path under each socket profile and run loop.
+//
+//   socket_latency_bench [--messages N] [--interval-us U] [--cpu C] [--sender-cpu S]
+//
+// A sender thread writes timestamped 64-byte messages at a fixed interval; the receiver
+// reads them through TimestampedStream. "default" leaves the profile untouched, so reads take
+// the plain tcp_stream path the feeds use out of the box and only total latency is known.
+// Modes with receive timestamps read through recvmsg() and also split the latency into
+// send -> kernel receive (network stack) and kernel receive -> handler (wake-up and
+// dispatch). Each mode runs its receiver on a fresh thread; busy-poll modes pin that thread
+// to --cpu, which should be an isolated core. The sender is pinned to --sender-cpu (by
+// default the core after --cpu) in every mode, so a spinning receiver never shares a core
+// with it.
+
+namespace {
+    namespace net = boost::asio;
+    using tcp = net::ip::tcp;
+
+    constexpr std::size_t kMessageSize = 64;
+    constexpr std::size_t kWarmup = 1000;
+
+    struct Mode {
+        const char* name;
+        poly::SocketProfile profile;
+        bool busy_poll;
+    };
+
+    struct Samples {
+        std::vector<uint64_t> total;     // send -> handler
+        std::vector<uint64_t> stack;     // send -> kernel receive
+        std::vector<uint64_t> dispatch;  // kernel receive -> handler
+    };
+
+    class Receiver {
+        poly::TimestampedStream stream_;
+        char message_[kMessageSize];
+        std::size_t seen_ = 0;
+        Samples& out_;
+    public:
+        Receiver(tcp::socket socket, Samples& out) : stream_(std::move(socket)), out_(out) {}
+
+        poly::TimestampedStream& stream() { return stream_; }
+
+        void start() {
+            net::async_read(stream_, net::buffer(message_), [this](boost::system::error_code ec, std::size_t) {
+                if (ec) return;
+                uint64_t now = poly::now_ns();
+                uint64_t sent;
+                std::memcpy(&sent, message_, sizeof(sent));
+                uint64_t kernel = stream_.last_receive_ns();
+
+                if (seen_++ >= kWarmup && now >= sent) {
+                    out_.total.push_back(now - sent);
+                    if (kernel >= sent && kernel <= now) {
+                        out_.stack.push_back(kernel - sent);
+                        out_.dispatch.push_back(now - kernel);
+                    }
+                }
+                start();
+            });
+        }
+    };
+
+    void send_messages(unsigned short port, std::size_t count, uint64_t interval_ns, int cpu) {
+        if (cpu >= 0) poly::pin_current_thread(cpu);
+        net::io_context ioc;
+        tcp::socket socket(ioc);
+        boost::system::error_code ec;
+        socket.connect({net::ip::address_v4::loopback(), port}, ec);
+        if (ec) {
+            spdlog::error("Sender: connect failed: {}", ec.message());
+            return;
+        }
+        socket.set_option(tcp::no_delay(true));
+
+        char message[kMessageSize] = {};
+        uint64_t next = poly::now_ns();
+        for (std::size_t i = 0; i < count; ++i) {
+            next += interval_ns;
+            // Spin rather than sleep so the send time does not depend on timer slack
+            while (poly::now_ns() < next) {}
+            uint64_t sent = poly::now_ns();
+            std::memcpy(message, &sent, sizeof(sent));
+            net::write(socket, net::buffer(message), ec);
+            if (ec) break;
+        }
+        socket.shutdown(tcp::socket::shutdown_both, ec);
+    }
+
+    bool run_mode(const Mode& mode, std::size_t count, uint64_t interval_ns, int cpu, int sender_cpu,
+                  Samples& out) {
+        net::io_context ioc(1);
+        tcp::acceptor acceptor(ioc, {net::ip::address_v4::loopback(), 0});
+        std::thread sender(send_messages, acceptor.local_endpoint().port(), count, interval_ns, sender_cpu);
+
+        boost::system::error_code ec;
+        tcp::socket socket(ioc);
+        acceptor.accept(socket, ec);
+        if (ec) {
+            spdlog::error("Accept failed: {}", ec.message());
+            sender.join();
+            return false;
+        }
+
+        Receiver receiver(std::move(socket), out);
+        receiver.stream().apply(mode.profile);
+        receiver.start();
+        // Pinning stays with this thread and dies with it, nothing leaks into the next mode
+        std::thread io([&] { poly::run_io(ioc, {mode.busy_poll, mode.busy_poll ? cpu : -1}); });
+        io.join();
+        sender.join();
+        return true;
+    }
+
+    double percentile_us(std::vector<uint64_t>& v, double q) {
+        if (v.empty()) return 0.0;
+        std::size_t i = std::min(v.size() - 1, static_cast<std::size_t>(q * v.size()));
+        std::nth_element(v.begin(), v.begin() + static_cast<std::ptrdiff_t>(i), v.end());
+        return v[i] / 1000.0;
+    }
+
+    void report(const char* mode, const char* part, std::vector<uint64_t>& v) {
+        std::printf("%-22s %-9s %8zu %9.2f %9.2f %9.2f %9.2f %9.2f\n", mode, part, v.size(),
+            percentile_us(v, 0.50), percentile_us(v, 0.90), percentile_us(v, 0.99),
+            percentile_us(v, 0.999), percentile_us(v, 1.0));
+    }
+}
+
+int main(int argc, char** argv) {
+    std::size_t messages = 20000;
+    uint64_t interval_us = 100;
+    int cpu = -1;
+    int sender_cpu = -1;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--messages" && i + 1 < argc) {
+                messages = std::stoul(argv[++i]);
+            } else if (arg == "--interval-us" && i + 1 < argc) {
+                interval_us = std::stoul(argv[++i]);
+            } else if (arg == "--cpu" && i + 1 < argc) {
+                cpu = std::stoi(argv[++i]);
+            } else if (arg == "--sender-cpu" && i + 1 < argc) {
+                sender_cpu = std::stoi(argv[++i]);
+            } else {
+                std::cerr << "usage: " << argv[0]
+                    << " [--messages N] [--interval-us U] [--cpu C] [--sender-cpu S]" << std::endl;
+                return 1;
+            }
+        }
+    } catch (const std::exception& e) {
+        spdlog::error("Bad arguments: {}", e.what());
+        return 1;
+    }
+
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    if (cpu >= 0 && sender_cpu < 0) sender_cpu = static_cast<int>((cpu + 1) % cores);
+    if (cpu >= 0 && sender_cpu == cpu) {
+        spdlog::warn("Receiver and sender share cpu {}, busy-poll rows will measure starvation", cpu);
+    }
+
+    poly::SocketProfile timestamps;
+    timestamps.rx_timestamps = true;
+    const std::vector<Mode> modes = {
+        {"run/default", {}, false},
+        {"run/timestamps", timestamps, false},
+        {"run/low_latency", poly::SocketProfile::low_latency(), false},
+        {"busy_poll/default", {}, true},
+        {"busy_poll/timestamps", timestamps, true},
+        {"busy_poll/low_latency", poly::SocketProfile::low_latency(), true},
+    };
+
+    std::printf("%-22s %-9s %8s %9s %9s %9s %9s %9s\n", "mode", "part", "samples",
+        "p50_us", "p90_us", "p99_us", "p99.9_us", "max_us");
+    for (const auto& mode : modes) {
+        Samples samples;
+        if (!run_mode(mode, messages, interval_us * 1000, cpu, sender_cpu, samples)) return 1;
+        report(mode.name, "total", samples.total);
+        // Without kernel timestamps there is nothing to split the total at
+        if (!mode.profile.rx_timestamps) continue;
+        report(mode.name, "stack", samples.stack);
+        report(mode.name, "dispatch", samples.dispatch);
+    }
+    return 0;
+}